@@ -0,0 +1,113 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2020 Laboratoire de Recherche et Développement
+// de l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "config.h"
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <spot/twa/acc.hh>
+#include <spot/misc/random.hh>
+#include <spot/misc/timer.hh>
+
+// Time the basic operations on acceptance marks.  The marks are
+// either "small" (using only the first 4 sets, as in most automata)
+// or "large" (using sets spread over all the supported sets).  Run
+// this in a default build and in builds configured with
+// --enable-max-accsets=N (with or without --enable-wide-marks) to
+// compare the cost of wider marks.
+
+namespace
+{
+  std::vector<spot::acc_cond::mark_t>
+  random_marks(unsigned count, unsigned nsets)
+  {
+    std::vector<spot::acc_cond::mark_t> res;
+    res.reserve(count);
+    for (unsigned i = 0; i < count; ++i)
+      {
+        spot::acc_cond::mark_t m = {};
+        for (unsigned s = 0; s < nsets; ++s)
+          if (spot::drand() < 0.3)
+            m.set(s);
+        res.push_back(m);
+      }
+    return res;
+  }
+
+  template<class F>
+  void
+  bench(const char* name, const char* kind, unsigned rounds,
+        const std::vector<spot::acc_cond::mark_t>& marks, F f)
+  {
+    unsigned long res = 0;
+    spot::stopwatch sw;
+    sw.start();
+    for (unsigned r = 0; r < rounds; ++r)
+      for (unsigned i = 1; i < marks.size(); ++i)
+        res += f(marks[i - 1], marks[i]);
+    double t = sw.stop();
+    // Print RES so that the loop cannot be optimized away.
+    std::cout << spot::acc_cond::mark_t::max_accsets() << ','
+              << kind << ',' << name << ',' << t << ',' << res << '\n';
+  }
+
+  void
+  bench_all(const char* kind, unsigned nsets, unsigned rounds)
+  {
+    typedef spot::acc_cond::mark_t mark_t;
+    auto marks = random_marks(1000, nsets);
+    bench("or", kind, rounds, marks,
+          [](mark_t a, mark_t b) { return (a | b).count(); });
+    bench("and", kind, rounds, marks,
+          [](mark_t a, mark_t b) { return !!(a & b); });
+    bench("eq", kind, rounds, marks,
+          [](mark_t a, mark_t b) { return a == b; });
+    bench("subset", kind, rounds, marks,
+          [](mark_t a, mark_t b) { return a.subset(b); });
+    bench("has", kind, rounds, marks,
+          [nsets](mark_t a, mark_t) { return a.has(nsets - 1); });
+    bench("max_set", kind, rounds, marks,
+          [](mark_t a, mark_t) { return a.max_set(); });
+    bench("sets", kind, rounds, marks,
+          [](mark_t a, mark_t)
+          {
+            unsigned sum = 0;
+            for (unsigned s: a.sets())
+              sum += s;
+            return sum;
+          });
+    spot::acc_cond acc(nsets);
+    acc.set_generalized_buchi();
+    bench("accepting", kind, rounds, marks,
+          [&acc](mark_t a, mark_t b) { return acc.accepting(a | b); });
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  unsigned rounds = 10000;
+  if (argc > 1)
+    rounds = strtoul(argv[1], nullptr, 10);
+  spot::srand(0);
+  std::cout << "max_accsets,marks,operation,time,result\n";
+  bench_all("small", 4, rounds);
+  bench_all("large", spot::acc_cond::mark_t::max_accsets(), rounds);
+  return 0;
+}
@@ -0,0 +1,212 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2020 Laboratoire de Recherche et Développement
+// de l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "config.h"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <spot/kripke/kripkegraph.hh>
+#include <spot/twa/twaproduct.hh>
+#include <spot/twaalgos/emptiness.hh>
+#include <spot/misc/memusage.hh>
+#include <spot/misc/random.hh>
+#include <spot/misc/timer.hh>
+
+// Compare state_map (std::unordered_map) and state_open_map (open
+// addressing) on the states of the product of a random Kripke
+// structure with a random automaton, then run the emptiness checks
+// on this product.  The product is empty, so that all its states
+// are visited.  The memory used by the emptiness checks is the
+// growth of the process size, in pages: run this before and after a
+// change to the emptiness checks, since the process does not shrink
+// after a check.
+
+namespace
+{
+  // Count the bytes allocated by a container.
+  std::size_t allocated = 0;
+
+  template<class T>
+  struct counting_alloc
+  {
+    typedef T value_type;
+
+    counting_alloc() = default;
+
+    template<class U>
+    counting_alloc(const counting_alloc<U>&)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+      allocated += n * sizeof(T);
+      return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+      allocated -= n * sizeof(T);
+      std::allocator<T>().deallocate(p, n);
+    }
+
+    template<class U>
+    bool operator==(const counting_alloc<U>&) const
+    {
+      return true;
+    }
+
+    template<class U>
+    bool operator!=(const counting_alloc<U>&) const
+    {
+      return false;
+    }
+  };
+
+  spot::twa_product_ptr
+  random_product(const spot::bdd_dict_ptr& dict, unsigned states)
+  {
+    auto k = spot::make_kripke_graph(dict);
+    bdd a = bdd_ithvar(k->register_ap("a"));
+    bdd b = bdd_ithvar(k->register_ap("b"));
+    bdd conds[4] = { a & b, a & !b, !a & b, !a & !b };
+    for (unsigned s = 0; s < states; ++s)
+      k->new_state(conds[spot::mrand(4)]);
+    for (unsigned s = 0; s < states; ++s)
+      {
+        // Ensure that most states are reachable.
+        k->new_edge(s, (s + 1) % states);
+        k->new_edge(s, spot::mrand(states));
+        k->new_edge(s, spot::mrand(states));
+      }
+    k->set_init_state(0);
+
+    // An automaton with no accepting edge.
+    auto aut = spot::make_twa_graph(dict);
+    aut->copy_ap_of(k);
+    aut->set_buchi();
+    unsigned n = 8;
+    aut->new_states(n);
+    for (unsigned s = 0; s < n; ++s)
+      for (unsigned i = 0; i < 4; ++i)
+        aut->new_edge(s, spot::mrand(n), conds[spot::mrand(4)] | conds[i]);
+    aut->set_init_state(0);
+    return spot::otf_product(k, aut);
+  }
+
+  // Visit all the states of PROD with a breadth-first search using
+  // a table of type Map.
+  template<class Map>
+  void
+  visit(const spot::const_twa_ptr& prod, Map& m)
+  {
+    std::vector<const spot::state*> todo;
+    const spot::state* init = prod->get_init_state();
+    m.emplace(init, 0);
+    todo.push_back(init);
+    for (unsigned pos = 0; pos < todo.size(); ++pos)
+      for (auto i: prod->succ(todo[pos]))
+        {
+          const spot::state* s = i->dst();
+          if (m.emplace(s, 0).second)
+            todo.push_back(s);
+          else
+            s->destroy();
+        }
+  }
+
+  template<class Map>
+  void
+  destroy_keys(Map& m)
+  {
+    for (auto& p: m)
+      p.first->destroy();
+  }
+
+  void
+  bench_tables(const spot::const_twa_ptr& prod)
+  {
+    spot::stopwatch sw;
+    {
+      std::unordered_map<const spot::state*, int,
+                         spot::state_ptr_hash, spot::state_ptr_equal,
+                         counting_alloc<std::pair<const spot::state* const,
+                                                  int>>> m;
+      sw.start();
+      visit(prod, m);
+      double t = sw.stop();
+      std::cout << "table,state_map," << m.size() << ','
+                << t << ',' << allocated << '\n';
+      destroy_keys(m);
+    }
+    {
+      spot::state_open_map<int> m;
+      sw.start();
+      visit(prod, m);
+      double t = sw.stop();
+      // Each slot stores the hash value and the element.
+      std::size_t bytes = m.capacity() * (sizeof(std::size_t)
+                                          + sizeof(*m.begin()));
+      std::cout << "table,state_open_map," << m.size() << ','
+                << t << ',' << bytes << '\n';
+      destroy_keys(m);
+    }
+  }
+
+  void
+  bench_check(const spot::const_twa_ptr& prod, const char* algo)
+  {
+    const char* err;
+    auto inst = spot::make_emptiness_check_instantiator(algo, &err);
+    if (!inst)
+      {
+        std::cerr << "failed to parse `" << err << "'\n";
+        exit(2);
+      }
+    int mem = spot::memusage();
+    spot::stopwatch sw;
+    sw.start();
+    auto ec = inst->instantiate(prod);
+    bool nonempty = !!ec->check();
+    double t = sw.stop();
+    auto stats = dynamic_cast<const spot::ec_statistics*>(ec.get());
+    std::cout << "check," << algo << ','
+              << (stats ? int(stats->states()) : -1) << ',' << t << ','
+              << spot::memusage() - mem
+              << (nonempty ? ",nonempty" : ",empty") << '\n';
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  unsigned states = 200000;
+  if (argc > 1)
+    states = strtoul(argv[1], nullptr, 10);
+  spot::srand(0);
+  auto dict = spot::make_bdd_dict();
+  auto prod = random_product(dict, states);
+  std::cout << "kind,name,states,time,memory\n";
+  bench_tables(prod);
+  for (auto algo: {"Cou99", "SE05", "CVWY90", "Tau03"})
+    bench_check(prod, algo);
+  return 0;
+}
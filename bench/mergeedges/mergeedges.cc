@@ -0,0 +1,119 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2020 Laboratoire de Recherche et Développement
+// de l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "config.h"
+#include <cstdlib>
+#include <iostream>
+#include <spot/twa/twagraph.hh>
+#include <spot/misc/random.hh>
+#include <spot/misc/timer.hh>
+
+// Compare the two ways twa_graph::merge_edges() can sort edges: a
+// global stable sort (digraph::sort_edges_()), or a linear
+// distribution of the edges by source followed by a sort of the
+// successors of each state (digraph::sort_edges_srcfirst_()).  The
+// edges of the random automata are added in a random order, and
+// have a lot of duplicates to merge.
+
+namespace
+{
+  spot::twa_graph_ptr
+  random_aut(unsigned states, unsigned degree)
+  {
+    auto dict = spot::make_bdd_dict();
+    auto aut = spot::make_twa_graph(dict);
+    bdd a = bdd_ithvar(aut->register_ap("a"));
+    bdd b = bdd_ithvar(aut->register_ap("b"));
+    bdd conds[4] = { a & b, a & !b, !a & b, !a & !b };
+    aut->set_generalized_buchi(2);
+    aut->new_states(states);
+    unsigned edges = states * degree;
+    for (unsigned e = 0; e < edges; ++e)
+      {
+        unsigned src = spot::mrand(states);
+        // Pick destinations among a few states so that some edges
+        // can be merged.
+        unsigned dst = (src + spot::mrand(degree / 2 + 1)) % states;
+        unsigned set = spot::mrand(2);
+        aut->new_edge(src, dst, conds[spot::mrand(4)], {set});
+      }
+    return aut;
+  }
+
+  template<class F>
+  void
+  bench(const char* name, const spot::const_twa_graph_ptr& aut, F f)
+  {
+    auto copy = spot::make_twa_graph(aut, spot::twa::prop_set::all());
+    spot::stopwatch sw;
+    sw.start();
+    f(copy);
+    double t = sw.stop();
+    std::cout << aut->num_states() << ',' << aut->num_edges() << ','
+              << name << ',' << t << ',' << copy->num_edges() << '\n';
+  }
+
+  void
+  bench_all(unsigned states, unsigned degree)
+  {
+    typedef spot::twa_graph::edge_storage_t tr_t;
+    auto lt = [](const tr_t& lhs, const tr_t& rhs)
+      {
+        if (lhs.src < rhs.src)
+          return true;
+        if (lhs.src > rhs.src)
+          return false;
+        if (lhs.dst < rhs.dst)
+          return true;
+        if (lhs.dst > rhs.dst)
+          return false;
+        return lhs.acc < rhs.acc;
+      };
+    auto aut = random_aut(states, degree);
+    bench("sort", aut, [&](spot::twa_graph_ptr& a)
+          {
+            auto& g = a->get_graph();
+            g.sort_edges_(lt);
+            g.chain_edges_();
+          });
+    bench("srcfirst", aut, [&](spot::twa_graph_ptr& a)
+          {
+            auto& g = a->get_graph();
+            g.sort_edges_srcfirst_(lt);
+            g.chain_edges_();
+          });
+    bench("merge_edges", aut, [](spot::twa_graph_ptr& a)
+          {
+            a->merge_edges();
+          });
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  unsigned degree = 8;
+  if (argc > 1)
+    degree = strtoul(argv[1], nullptr, 10);
+  spot::srand(0);
+  std::cout << "states,edges,operation,time,result_edges\n";
+  for (unsigned states = 16; states <= (1U << 20); states *= 4)
+    bench_all(states, degree);
+  return 0;
+}
@@ -0,0 +1,78 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2020 Laboratoire de Recherche et Développement
+// de l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "config.h"
+#include <cstdlib>
+#include <iostream>
+#include <spot/gen/formulas.hh>
+#include <spot/tl/apcollect.hh>
+#include <spot/twaalgos/ltl2tgba_fm.hh>
+#include <spot/taalgos/minimize.hh>
+#include <spot/taalgos/stats.hh>
+#include <spot/taalgos/tgba2ta.hh>
+#include <spot/misc/timer.hh>
+
+// Time the translation of formulas of a few families of spot/gen into
+// TGBA, the conversion of these TGBA into TGTA, and the minimization
+// of the TGTA.  The size of the TGTA is exponential in the number of
+// atomic propositions.
+
+namespace
+{
+  void
+  bench(spot::gen::ltl_pattern_id pattern, int n,
+        const spot::bdd_dict_ptr& dict)
+  {
+    spot::formula f = spot::gen::ltl_pattern(pattern, n);
+    spot::stopwatch sw;
+    sw.start();
+    auto aut = spot::ltl_to_tgba_fm(f, dict);
+    double t_tgba = sw.stop();
+    bdd aps = spot::atomic_prop_collect_as_bdd(f, aut);
+    sw.start();
+    auto tgta = spot::tgba_to_tgta(aut, aps);
+    double t_tgta = sw.stop();
+    sw.start();
+    auto min = spot::minimize_tgta(tgta);
+    double t_min = sw.stop();
+    std::cout << spot::gen::ltl_pattern_name(pattern) << ',' << n << ','
+              << aut->num_states() << ',' << t_tgba << ','
+              << spot::stats_reachable(tgta->get_ta()).states << ','
+              << t_tgta << ','
+              << spot::stats_reachable(min->get_ta()).states << ',' << t_min
+              << '\n';
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  int max = 6;
+  if (argc > 1)
+    max = strtol(argv[1], nullptr, 10);
+
+  auto dict = spot::make_bdd_dict();
+  std::cout << ("family,n,tgba_states,tgba_time,"
+                "tgta_states,tgta_time,min_states,min_time\n");
+  for (auto pattern: {spot::gen::LTL_AND_GF, spot::gen::LTL_GH_R,
+                      spot::gen::LTL_U_LEFT, spot::gen::LTL_AND_F})
+    for (int n = 1; n <= max; ++n)
+      bench(pattern, n, dict);
+  return 0;
+}
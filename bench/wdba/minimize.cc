@@ -0,0 +1,120 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2020 Laboratoire de Recherche et Développement
+// de l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "config.h"
+#include <cstdlib>
+#include <iostream>
+#include <spot/tl/formula.hh>
+#include <spot/twaalgos/minimize.hh>
+#include <spot/twaalgos/translate.hh>
+#include <spot/misc/timer.hh>
+
+// Time minimize_monitor() and minimize_wdba() on families of
+// automata whose size grows with a parameter n.  Run this before and
+// after a change to the minimization algorithm.
+
+namespace
+{
+  spot::formula
+  nexts(unsigned n, spot::formula f)
+  {
+    while (n--)
+      f = spot::formula::X(f);
+    return f;
+  }
+
+  // A deterministic chain of n states, where state i reads a to go to
+  // state i+1, and the last state has no successor.  All its states
+  // are distinguishable, and a refinement that splits one set of
+  // states per pass needs n passes.
+  spot::twa_graph_ptr
+  chain(const spot::bdd_dict_ptr& dict, unsigned n)
+  {
+    auto aut = spot::make_twa_graph(dict);
+    bdd a = bdd_ithvar(aut->register_ap("a"));
+    bdd b = bdd_ithvar(aut->register_ap("b"));
+    aut->new_states(n);
+    for (unsigned s = 0; s + 1 < n; ++s)
+      {
+        aut->new_edge(s, s + 1, a);
+        aut->new_edge(s, s, !a & b);
+      }
+    aut->set_init_state(0);
+    aut->prop_state_acc(true);
+    return aut;
+  }
+
+  template<class F>
+  void
+  bench(const char* family, unsigned n,
+        const spot::const_twa_graph_ptr& aut, F f)
+  {
+    spot::stopwatch sw;
+    sw.start();
+    auto res = f(aut);
+    double t = sw.stop();
+    std::cout << family << ',' << n << ',' << aut->num_states() << ','
+              << t << ',' << res->num_states() << '\n';
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  unsigned max = 12;
+  if (argc > 1)
+    max = strtoul(argv[1], nullptr, 10);
+
+  auto dict = spot::make_bdd_dict();
+  auto monitor = [](const spot::const_twa_graph_ptr& aut)
+    {
+      return spot::minimize_monitor(aut);
+    };
+  auto wdba = [](const spot::const_twa_graph_ptr& aut)
+    {
+      return spot::minimize_wdba(aut);
+    };
+
+  spot::formula a = spot::formula::ap("a");
+  spot::formula b = spot::formula::ap("b");
+  spot::formula c = spot::formula::ap("c");
+  spot::formula d = spot::formula::ap("d");
+
+  std::cout << "family,n,input_states,time,output_states\n";
+  for (unsigned n = 4; n <= max; ++n)
+    bench("chain", n, chain(dict, 1U << n), monitor);
+  for (unsigned n = 4; n <= max; ++n)
+    {
+      // F(a & X^n b)
+      spot::translator trans(dict);
+      trans.set_level(spot::postprocessor::Low);
+      auto f = spot::formula::F(spot::formula::And({a, nexts(n, b)}));
+      bench("fxb", n, trans.run(f), wdba);
+    }
+  for (unsigned n = 2; n <= max / 2; ++n)
+    {
+      // F(a & X^n b) & F(c & X^n d)
+      spot::translator trans(dict);
+      trans.set_level(spot::postprocessor::Low);
+      auto f1 = spot::formula::F(spot::formula::And({a, nexts(n, b)}));
+      auto f2 = spot::formula::F(spot::formula::And({c, nexts(n, d)}));
+      bench("fxb2", n, trans.run(spot::formula::And({f1, f2})), wdba);
+    }
+  return 0;
+}
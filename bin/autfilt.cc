@@ -74,6 +74,7 @@
 #include <spot/twaalgos/stutter.hh>
 #include <spot/twaalgos/sum.hh>
 #include <spot/twaalgos/totgba.hh>
+#include <spot/twaalgos/wordcheck.hh>
 
 static const char argp_program_doc[] ="\
 Convert, transform, and filter omega-automata.\v\
@@ -565,8 +566,8 @@ static struct opt_t
   std::unique_ptr<unique_aut_t> uniq = nullptr;
   spot::exclusive_ap excl_ap;
   spot::remove_ap rem_ap;
-  std::vector<spot::twa_graph_ptr> acc_words;
-  std::vector<spot::twa_graph_ptr> rej_words;
+  std::vector<spot::twa_word_ptr> acc_words;
+  std::vector<spot::twa_word_ptr> rej_words;
   std::vector<std::pair<spot::twa_graph_ptr, unsigned>> hl_words;
 }* opt;
 
@@ -729,8 +730,7 @@ parse_opt(int key, char* arg, struct argp_state*)
     case OPT_ACCEPT_WORD:
       try
         {
-          opt->acc_words.push_back(spot::parse_word(arg, opt->dict)
-                                   ->as_automaton());
+          opt->acc_words.push_back(spot::parse_word(arg, opt->dict));
         }
       catch (const spot::parse_error& e)
         {
@@ -1054,8 +1054,7 @@ parse_opt(int key, char* arg, struct argp_state*)
     case OPT_REJECT_WORD:
       try
         {
-          opt->rej_words.push_back(spot::parse_word(arg, opt->dict)
-                                   ->as_automaton());
+          opt->rej_words.push_back(spot::parse_word(arg, opt->dict));
         }
       catch (const spot::parse_error& e)
         {
@@ -1425,20 +1424,23 @@ namespace
         matched &= !aut->intersects(opt->equivalent_neg)
           && spot::contains(aut, opt->equivalent_pos);
 
-      if (matched && !opt->acc_words.empty())
-        for (auto& word_aut: opt->acc_words)
-          if (spot::product(aut, word_aut)->is_empty())
-            {
-              matched = false;
-              break;
-            }
-      if (matched && !opt->rej_words.empty())
-        for (auto& word_aut: opt->rej_words)
-          if (!spot::product(aut, word_aut)->is_empty())
-            {
-              matched = false;
-              break;
-            }
+      if (matched && (!opt->acc_words.empty() || !opt->rej_words.empty()))
+        {
+          spot::word_checker wc(aut);
+          for (auto& word: opt->acc_words)
+            if (!wc.accepts(*word))
+              {
+                matched = false;
+                break;
+              }
+          if (matched)
+            for (auto& word: opt->rej_words)
+              if (wc.accepts(*word))
+                {
+                  matched = false;
+                  break;
+                }
+        }
       if (opt_is_stutter_invariant)
         {
           check_stutter_invariance(aut);
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2012-2019 Laboratoire de Recherche et Développement
+// Copyright (C) 2012-2020 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -39,6 +39,7 @@
 #include <spot/twaalgos/strength.hh>
 #include <spot/twaalgos/stutter.hh>
 #include <spot/twaalgos/isdet.hh>
+#include <spot/twaalgos/translate.hh>
 
 automaton_format_t automaton_format = Hoa;
 static const char* automaton_format_opt = nullptr;
@@ -278,6 +279,10 @@ static const argp_option o_options[] =
       "or (c) children processes.", 0 },
     { "%n", 0, nullptr, OPTION_DOC | OPTION_NO_USAGE,
       "number of nondeterministic states in output", 0 },
+    { "%o", 0, nullptr, OPTION_DOC | OPTION_NO_USAGE,
+      "comma-separated list of the wall-clock times (in seconds) spent "
+      "translating each subformula that was translated separately "
+      "(see the ltl-split option in spot-x(7))", 0 },
     { "%u, %[LETTER]u", 0, nullptr, OPTION_DOC | OPTION_NO_USAGE,
       "1 if the automaton contains some universal branching "
       "(or a number of [s]tates or [e]dges with universal branching)", 0 },
@@ -421,6 +426,8 @@ hoa_stat_printer::hoa_stat_printer(std::ostream& os, const char* format,
     declare('f', &filename_);        // Override the formula printer.
   declare('h', &output_aut_);
   declare('m', &aut_name_);
+  if (input == ltl_input)
+    declare('o', &aut_parts_);
   declare('u', &aut_univbranch_);
   declare('w', &aut_word_);
   declare('x', &aut_ap_);
@@ -527,6 +534,21 @@ hoa_stat_printer::print(const spot::const_parsed_aut_ptr& haut,
       else
         aut_name_.val().clear();
     }
+  if (has('o'))
+    {
+      std::ostringstream out;
+      if (auto parts =
+          aut->get_named_prop<spot::translation_parts>("translation-parts"))
+        {
+          const char* sep = "";
+          for (auto& p: *parts)
+            {
+              out << sep << p.second;
+              sep = ",";
+            }
+        }
+      aut_parts_ = out.str();
+    }
   if (has('u'))
     aut_univbranch_ = aut;
   if (has('w'))
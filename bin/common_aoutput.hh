@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2014-2018 Laboratoire de Recherche et Développement
+// Copyright (C) 2014-2018, 2020 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -163,6 +163,7 @@ private:
   spot::printable_value<std::string> haut_name_;
   spot::printable_value<std::string> aut_name_;
   spot::printable_value<std::string> aut_word_;
+  spot::printable_value<std::string> aut_parts_;
   spot::printable_value<std::string> haut_word_;
   spot::printable_acc_cond haut_gen_acc_;
   spot::printable_value<unsigned> haut_states_;
@@ -19,10 +19,14 @@
 
 #include "common_sys.hh"
 
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <list>
+#include <sstream>
 #include <argp.h>
 #include <cstring>
 #include "error.h"
@@ -36,6 +40,7 @@
 #include "common_range.hh"
 
 #include <spot/misc/hash.hh>
+#include <spot/misc/hashfunc.hh>
 #include <spot/misc/timer.hh>
 #include <spot/tl/simplify.hh>
 #include <spot/tl/length.hh>
@@ -51,12 +56,12 @@
 #include <spot/twaalgos/ltl2tgba_fm.hh>
 #include <spot/twaalgos/minimize.hh>
 #include <spot/twaalgos/postproc.hh>
-#include <spot/twaalgos/product.hh>
 #include <spot/twaalgos/remfin.hh>
 #include <spot/twaalgos/strength.hh>
 #include <spot/twaalgos/stutter.hh>
 #include <spot/twaalgos/totgba.hh>
 #include <spot/twaalgos/word.hh>
+#include <spot/twaalgos/wordcheck.hh>
 
 const char argp_program_doc[] ="\
 Read a list of formulas and output them back after some optional processing.\v\
@@ -73,6 +78,7 @@ enum {
   OPT_BSIZE,
   OPT_BSIZE_MAX,
   OPT_BSIZE_MIN,
+  OPT_BUILD_INDEX,
   OPT_DEFINE,
   OPT_DROP_ERRORS,
   OPT_EQUIVALENT_TO,
@@ -109,7 +115,9 @@ enum {
   OPT_SYNTACTIC_SAFETY,
   OPT_SYNTACTIC_SI,
   OPT_UNABBREVIATE,
+  OPT_UNIQUE_EQUIVALENT,
   OPT_UNIVERSAL,
+  OPT_USE_INDEX,
 };
 
 static const argp_option options[] =
@@ -226,10 +234,16 @@ static const argp_option options[] =
     { "invert-match", 'v', nullptr, 0, "select non-matching formulas", 0},
     { "unique", 'u', nullptr, 0,
       "drop formulas that have already been output (not affected by -v)", 0 },
+    { "unique-equivalent", OPT_UNIQUE_EQUIVALENT, nullptr, 0,
+      "drop formulas that are equivalent to a formula already output", 0 },
     { "accept-word", OPT_ACCEPT_WORD, "WORD", 0,
       "keep formulas that accept WORD", 0 },
     { "reject-word", OPT_REJECT_WORD, "WORD", 0,
       "keep formulas that reject WORD", 0 },
+    { "use-index", OPT_USE_INDEX, "FILENAME", 0,
+      "read formulas from an index built with --build-index, and use the "
+      "properties it stores instead of recomputing them; formulas may "
+      "not be transformed when reading an index", 0 },
     RANGE_DOC_FULL,
     WORD_DOC,
     /**************************************************/
@@ -237,6 +251,12 @@ static const argp_option options[] =
     { "count", 'c', nullptr, 0, "print only a count of matched formulas", 0 },
     { "quiet", 'q', nullptr, 0, "suppress all normal output", 0 },
     { "max-count", 'n', "NUM", 0, "output at most NUM formulas", 0 },
+    { "build-index", OPT_BUILD_INDEX, nullptr, 0,
+      "output an index of the formulas, i.e., a CSV file with the "
+      "formula, its class in the Manna-Pnueli hierarchy, whether it is "
+      "stutter-invariant (0 or 1), its size, its Boolean-size, and "
+      "its number of atomic propositions, to be read with --use-index",
+      0 },
     { nullptr, 0, nullptr, 0, "The FORMAT string passed to --format may use "\
       "the following interpreted sequences:", -19 },
     { "%f", 0, nullptr, OPTION_DOC | OPTION_NO_USAGE,
@@ -283,6 +303,7 @@ static bool nnf = false;
 static bool negate = false;
 static bool boolean_to_isop = false;
 static bool unique = false;
+static bool unique_equivalent = false;
 static bool psl = false;
 static bool liveness = false;
 static bool ltl = false;
@@ -312,6 +333,8 @@ static range ap_n = { -1, -1 };
 static int opt_max_count = -1;
 static long int match_count = 0;
 static const char* from_ltlf = nullptr;
+static bool build_index = false;
+static bool use_index = false;
 
 
 // We want all these variables to be destroyed when we exit main, to
@@ -326,8 +349,9 @@ static struct opt_t
   spot::formula implied_by = nullptr;
   spot::formula imply = nullptr;
   spot::formula equivalent_to = nullptr;
-  std::vector<spot::twa_graph_ptr> acc_words;
-  std::vector<spot::twa_graph_ptr> rej_words;
+  std::vector<spot::twa_word_ptr> acc_words;
+  std::vector<spot::twa_word_ptr> rej_words;
+  std::list<std::string> index_files;
 }* opt;
 
 static std::string unabbreviate;
@@ -375,8 +399,7 @@ parse_opt(int key, char* arg, struct argp_state*)
     case OPT_ACCEPT_WORD:
       try
         {
-          opt->acc_words.push_back(spot::parse_word(arg, opt->dict)
-                                   ->as_automaton());
+          opt->acc_words.push_back(spot::parse_word(arg, opt->dict));
         }
       catch (const spot::parse_error& e)
         {
@@ -399,6 +422,9 @@ parse_opt(int key, char* arg, struct argp_state*)
     case OPT_BSIZE_MAX:
       bsize.max = to_int(arg, "--bsize-max");
       break;
+    case OPT_BUILD_INDEX:
+      build_index = true;
+      break;
     case OPT_DEFINE:
       opt->output_define.reset(new output_file(arg ? arg : "-"));
       break;
@@ -465,8 +491,7 @@ parse_opt(int key, char* arg, struct argp_state*)
     case OPT_REJECT_WORD:
       try
         {
-          opt->rej_words.push_back(spot::parse_word(arg, opt->dict)
-                                   ->as_automaton());
+          opt->rej_words.push_back(spot::parse_word(arg, opt->dict));
         }
       catch (const spot::parse_error& e)
         {
@@ -541,9 +566,18 @@ parse_opt(int key, char* arg, struct argp_state*)
     case OPT_SYNTACTIC_SI:
       syntactic_si = true;
       break;
+    case OPT_UNIQUE_EQUIVALENT:
+      unique_equivalent = true;
+      break;
     case OPT_UNIVERSAL:
       universal = true;
       break;
+    case OPT_USE_INDEX:
+      // The formulas are in the first column of the index.
+      use_index = true;
+      opt->index_files.emplace_back(std::string(arg) + "/1");
+      jobs.emplace_back(opt->index_files.back().c_str(), true);
+      break;
     default:
       return ARGP_ERR_UNKNOWN;
     }
@@ -556,15 +590,147 @@ std::unordered_set<spot::formula> fset_t;
 
 namespace
 {
+  // The properties of a formula stored in the columns of an index
+  // built with --build-index, after the formula itself.
+  struct index_entry
+  {
+    char mp_class;
+    bool stutter_invariant;
+    int size;
+    int bsize;
+    int ap_count;
+  };
+
+  static std::string
+  index_columns(spot::formula f)
+  {
+    auto aps = atomic_prop_collect(f);
+    std::ostringstream os;
+    os << spot::mp_class(f) << ',' << spot::is_stutter_invariant(f)
+       << ',' << spot::length(f) << ',' << spot::length_boolone(f)
+       << ',' << aps->size();
+    delete aps;
+    return os.str();
+  }
+
+  static bool
+  parse_index_columns(const char* str, index_entry& e)
+  {
+    if (!str)
+      return false;
+    int si = -1;
+    int end = -1;
+    std::sscanf(str, "%c,%d,%d,%d,%d%n", &e.mp_class, &si,
+                &e.size, &e.bsize, &e.ap_count, &end);
+    e.stutter_invariant = si == 1;
+    return end >= 0 && !str[end] && (si == 0 || si == 1)
+      && e.mp_class && std::strchr("BGSOPRT", e.mp_class);
+  }
+
+  // Whether a formula of class C (as returned by spot::mp_class())
+  // matches the --safety, --guarantee, --obligation, --recurrence,
+  // and --persistence filters.
+  static bool
+  class_matches(char c)
+  {
+    return (!safety || std::strchr("BS", c))
+      && (!guarantee || std::strchr("BG", c))
+      && (!obligation || std::strchr("BSGO", c))
+      && (!recurrence || std::strchr("BSGOR", c))
+      && (!persistence || std::strchr("BSGOP", c));
+  }
+
+  // A set of formulas up to language equivalence.  Comparing each
+  // new formula to all the formulas of the set would be quadratic, so
+  // the formulas are grouped by a fingerprint made of their
+  // acceptance of a fixed set of random lasso words, and
+  // are_equivalent() is only called on formulas with the same
+  // fingerprint.
+  class equivalence_set
+  {
+  public:
+    equivalence_set(spot::tl_simplifier& simpl)
+      : simpl_(simpl)
+    {
+    }
+
+    // Insert F, unless the set has a formula equivalent to F.  Return
+    // true iff F was inserted.
+    bool insert(spot::formula f)
+    {
+      auto& bucket = buckets_[fingerprint(f)];
+      for (auto& g: bucket)
+        if (simpl_.are_equivalent(f, g))
+          return false;
+      bucket.push_back(f);
+      return true;
+    }
+
+  private:
+    // The number of words (i.e., of bits) of a fingerprint.
+    static constexpr unsigned num_words = 64;
+
+    // Bit I of the fingerprint of F tells whether F accepts the Ith
+    // word.  Two equivalent formulas can have different atomic
+    // propositions (e.g., "a | !a" and "1"), so the words are
+    // defined over all possible atomic propositions: the value of
+    // each proposition at each position of a word depends only on
+    // its name, so the words restricted to the atomic propositions
+    // of F are the same for all formulas.
+    std::uint64_t fingerprint(spot::formula f)
+    {
+      auto aut = ltl_to_tgba_fm(f, simpl_.get_dict(), true);
+      std::vector<std::pair<bdd, size_t>> aps;
+      for (auto ap: aut->ap())
+        {
+          const std::string& name = ap.ap_name();
+          aps.emplace_back(bdd_ithvar(aut->register_ap(ap)),
+                           spot::fnv_hash(name.begin(), name.end()));
+        }
+      spot::word_checker wc(aut);
+      std::uint64_t res = 0;
+      for (unsigned i = 0; i < num_words; ++i)
+        {
+          // Vary the shape of the lassos.
+          unsigned prefix_len = i % 3;
+          unsigned cycle_len = 1 + (i / 3) % 4;
+          auto word = spot::make_twa_word(aut->get_dict());
+          for (unsigned pos = 0; pos < prefix_len + cycle_len; ++pos)
+            {
+              size_t h = spot::wang32_hash((i << 8) | pos);
+              bdd letter = bddtrue;
+              for (auto& p: aps)
+                letter &= (spot::wang32_hash(p.second ^ h) & 1)
+                  ? p.first : !p.first;
+              (pos < prefix_len ? word->prefix : word->cycle)
+                .push_back(letter);
+            }
+          if (wc.accepts(*word))
+            res |= std::uint64_t(1) << i;
+        }
+      return res;
+    }
+
+    spot::tl_simplifier& simpl_;
+    std::unordered_map<std::uint64_t, std::vector<spot::formula>> buckets_;
+  };
+
   class ltl_processor final: public job_processor
   {
   public:
     spot::tl_simplifier& simpl;
     fset_t unique_set;
+    equivalence_set equivalent_set;
     spot::relabeling_map relmap;
+    // The index entry of the formula being processed, with --use-index.
+    const index_entry* idx = nullptr;
+    // The class and stutter-invariance of --equivalent-to's argument,
+    // computed when first needed.
+    char equivalent_class = 0;
+    bool equivalent_si = false;
 
     ltl_processor(spot::tl_simplifier& simpl)
-      : simpl(simpl)
+      : simpl(simpl), equivalent_set(simpl)
     {
     }
 
@@ -590,9 +756,19 @@ namespace
             check_cout();
             return !ignore_errors;
           }
+      index_entry entry;
+      if (use_index)
+        {
+          if (!parse_index_columns(suffix, entry))
+            error_at_line(2, 0, filename, linenum,
+                          "invalid index entry for this formula");
+          idx = &entry;
+        }
       try
         {
-          return process_formula(pf.f, filename, linenum);
+          int res = process_formula(pf.f, filename, linenum);
+          idx = nullptr;
+          return res;
         }
       catch (const std::runtime_error& e)
         {
@@ -674,32 +850,63 @@ namespace
       matched &= !syntactic_si || f.is_syntactic_stutter_invariant();
       if (matched && (ap_n.min > 0 || ap_n.max >= 0))
         {
-          auto s = atomic_prop_collect(f);
-          int n = s->size();
-          delete s;
+          int n;
+          if (idx)
+            {
+              n = idx->ap_count;
+            }
+          else
+            {
+              auto s = atomic_prop_collect(f);
+              n = s->size();
+              delete s;
+            }
           matched &= (ap_n.min <= 0) || (n >= ap_n.min);
           matched &= (ap_n.max < 0) || (n <= ap_n.max);
         }
 
       if (matched && (size.min > 0 || size.max >= 0))
         {
-          int l = spot::length(f);
+          int l = idx ? idx->size : spot::length(f);
           matched &= (size.min <= 0) || (l >= size.min);
           matched &= (size.max < 0) || (l <= size.max);
         }
 
       if (matched && (bsize.min > 0 || bsize.max >= 0))
         {
-          int l = spot::length_boolone(f);
+          int l = idx ? idx->bsize : spot::length_boolone(f);
           matched &= (bsize.min <= 0) || (l >= bsize.min);
           matched &= (bsize.max < 0) || (l <= bsize.max);
         }
 
-      matched &= !opt->implied_by || simpl.implication(opt->implied_by, f);
-      matched &= !opt->imply || simpl.implication(f, opt->imply);
-      matched &= !opt->equivalent_to
-        || simpl.are_equivalent(f, opt->equivalent_to);
-      matched &= !stutter_insensitive || spot::is_stutter_invariant(f);
+      // The cheap checks of an index entry go first, so that the
+      // expensive checks below can be skipped.
+      if (matched && idx)
+        {
+          matched &= !stutter_insensitive || idx->stutter_invariant;
+          matched &= class_matches(idx->mp_class);
+          // Equivalent formulas have the same class and the same
+          // stutter-invariance.
+          if (matched && opt->equivalent_to)
+            {
+              if (!equivalent_class)
+                {
+                  equivalent_class = spot::mp_class(opt->equivalent_to);
+                  equivalent_si =
+                    spot::is_stutter_invariant(opt->equivalent_to);
+                }
+              matched &= idx->mp_class == equivalent_class
+                && idx->stutter_invariant == equivalent_si;
+            }
+        }
+
+      matched = matched
+        && (!opt->implied_by || simpl.implication(opt->implied_by, f));
+      matched = matched && (!opt->imply || simpl.implication(f, opt->imply));
+      matched = matched && (!opt->equivalent_to
+                            || simpl.are_equivalent(f, opt->equivalent_to));
+      matched = matched && (idx || !stutter_insensitive
+                            || spot::is_stutter_invariant(f));
 
       if (matched && (obligation || recurrence || persistence
                       || !opt->acc_words.empty()
@@ -712,17 +919,17 @@ namespace
             {
               aut = ltl_to_tgba_fm(f, simpl.get_dict(), true);
 
-              if (matched && !opt->acc_words.empty())
-                for (auto& word_aut: opt->acc_words)
-                  if (spot::product(aut, word_aut)->is_empty())
-                    {
-                      matched = false;
-                      break;
-                    }
+              spot::word_checker wc(aut);
+              for (auto& word: opt->acc_words)
+                if (!wc.accepts(*word))
+                  {
+                    matched = false;
+                    break;
+                  }
 
-              if (matched && !opt->rej_words.empty())
-                for (auto& word_aut: opt->rej_words)
-                  if (!spot::product(aut, word_aut)->is_empty())
+              if (matched)
+                for (auto& word: opt->rej_words)
+                  if (wc.accepts(*word))
                     {
                       matched = false;
                       break;
@@ -740,7 +947,8 @@ namespace
             persistence = false;
 
           // Try a syntactic match before looking at the automata.
-          if (matched &&
+          // The class of indexed formulas has already been checked.
+          if (matched && !idx &&
               !((!persistence || f.is_syntactic_persistence())
                 && (!recurrence || f.is_syntactic_recurrence())
                 && (!guarantee || f.is_syntactic_guarantee())
@@ -785,6 +993,11 @@ namespace
       if (unique && !unique_set.insert(f).second)
         matched = false;
 
+      // This is the most costly check, so do it last, and only
+      // remember the formulas that are output.
+      if (matched && unique_equivalent && !equivalent_set.insert(f))
+        matched = false;
+
       timer.stop();
 
       if (matched)
@@ -804,7 +1017,19 @@ namespace
                                std::to_string(linenum).c_str()) << ")\n";
             }
           one_match = true;
-          output_formula_checked(f, &timer, filename, linenum, prefix, suffix);
+          if (build_index)
+            {
+              // An index entry does not depend on the transformations
+              // (that are disabled by --use-index), so keep it.
+              std::string cols = idx ? suffix : index_columns(f);
+              output_formula_checked(f, &timer, filename, linenum,
+                                     nullptr, cols.c_str());
+            }
+          else
+            {
+              output_formula_checked(f, &timer, filename, linenum,
+                                     prefix, suffix);
+            }
           ++match_count;
         }
       return 0;
@@ -830,6 +1055,17 @@ main(int argc, char** argv)
       if (jobs.empty())
         jobs.emplace_back("-", 1);
 
+      if (use_index)
+        {
+          if (jobs.size() != opt->index_files.size())
+            error(2, 0, "--use-index cannot be combined with other inputs");
+          if (negate || from_ltlf || remove_x || simplification_level
+              || boolean_to_isop || nnf || relabeling
+              || !unabbreviate.empty() || !opt->excl_ap.empty())
+            error(2, 0, "--use-index cannot be combined with options "
+                  "that transform the formulas");
+        }
+
       if (boolean_to_isop && simplification_level == 0)
         simplification_level = 1;
       spot::tl_simplifier_options tlopt(simplification_level);
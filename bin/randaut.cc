@@ -22,6 +22,7 @@
 #include <iostream>
 #include <fstream>
 #include <argp.h>
+#include <climits>
 #include <cstdlib>
 #include <sstream>
 #include <iterator>
@@ -36,6 +37,7 @@
 
 #include <spot/misc/timer.hh>
 #include <spot/misc/random.hh>
+#include <spot/misc/hashfunc.hh>
 
 #include <spot/twa/bddprint.hh>
 #include <spot/twaalgos/randomgraph.hh>
@@ -69,6 +71,7 @@ a high density of edges, and 3 to 4 atomic propositions:\n\
 enum {
   OPT_SEED = 1,
   OPT_COLORED,
+  OPT_PART,
 };
 
 static const argp_option options[] =
@@ -94,6 +97,12 @@ static const argp_option options[] =
       "are isomorphic)", 0 },
     { "seed", OPT_SEED, "INT", 0,
       "seed for the random number generator (0)", 0 },
+    { "part", OPT_PART, "I/K", 0,
+      "only output the automata whose number is I modulo K, and generate "
+      "each automaton from its own seed, derived from the seed and the "
+      "automaton number; K processes running with --part=0/K, ..., "
+      "--part=K-1/K output the same automata as --part=0/1 "
+      "(incompatible with --unique)", 0 },
     { "states", 'Q', "RANGE", 0, "number of states to output (10)", 0 },
     { "state-based-acceptance", 'S', nullptr, 0,
       "used state-based acceptance", 0 },
@@ -159,6 +168,8 @@ static bool ba_wanted = false;
 static bool generic_wanted = false;
 static bool gba_wanted = false;
 static std::unique_ptr<unique_aut_t> opt_uniq = nullptr;
+static int opt_part = 0;
+static int opt_parts = 0;       // 0 if --part is not used.
 
 static void
 ba_options()
@@ -179,6 +190,33 @@ looks_like_a_range(const char* str)
   return !*str;
 }
 
+static void
+parse_part(const char* arg)
+{
+  char* endptr;
+  long i = strtol(arg, &endptr, 10);
+  long k = 0;
+  if (endptr != arg && *endptr == '/')
+    {
+      const char* kstr = endptr + 1;
+      k = strtol(kstr, &endptr, 10);
+      if (endptr == kstr)
+        k = 0;
+    }
+  if (*endptr || k <= 0 || i < 0 || i >= k || k > INT_MAX)
+    error(2, 0, "failed to parse '%s' as I/K with 0 <= I < K "
+          "(in argument of --part)", arg);
+  opt_part = i;
+  opt_parts = k;
+}
+
+// The seed used to generate automaton NUM with --part.
+static unsigned
+automaton_seed(int num)
+{
+  return spot::wang32_hash(opt_seed ^ spot::wang32_hash(num));
+}
+
 static int
 parse_opt(int key, char* arg, struct argp_state* as)
 {
@@ -239,6 +277,9 @@ parse_opt(int key, char* arg, struct argp_state* as)
     case OPT_COLORED:
       opt_colored = true;
       break;
+    case OPT_PART:
+      parse_part(arg);
+      break;
     case OPT_SEED:
       opt_seed = to_int(arg, "--seed");
       opt_seed_str = arg;
@@ -325,7 +366,10 @@ main(int argc, char** argv)
       if (opt_acc_sets.min == -1)
         opt_acc_sets.min = 0;
 
-      spot::srand(opt_seed);
+      if (opt_parts && opt_uniq)
+        error(2, 0, "--part and --unique may not be used together");
+
+      spot::random_generator gen(opt_seed);
       auto d = spot::make_bdd_dict();
 
       automaton_printer printer;
@@ -333,32 +377,39 @@ main(int argc, char** argv)
       constexpr unsigned max_trials = 10000;
       unsigned trials = max_trials;
 
-      int automaton_num = 0;
+      // With --part, only generate the automata of this part, each
+      // with its own seed, so that they do not depend on the
+      // automata of the other parts.
+      int automaton_num = opt_parts ? opt_part : 0;
+      int automaton_step = opt_parts ? opt_parts : 1;
 
-      for (;;)
+      while (opt_automata <= 0 || automaton_num < opt_automata)
         {
+          if (opt_parts)
+            gen.seed(automaton_seed(automaton_num));
+
           spot::process_timer timer;
           timer.start();
 
           if (ap_count_given.max > 0
               && ap_count_given.min != ap_count_given.max)
             {
-              int c = spot::rrand(ap_count_given.min, ap_count_given.max);
+              int c = gen.rrand(ap_count_given.min, ap_count_given.max);
               opt->aprops = spot::create_atomic_prop_set(c);
             }
 
           int size = opt_states.min;
           if (size != opt_states.max)
-            size = spot::rrand(size, opt_states.max);
+            size = gen.rrand(size, opt_states.max);
 
           int accs = opt_acc_sets.min;
           if (accs != opt_acc_sets.max)
-            accs = spot::rrand(accs, opt_acc_sets.max);
+            accs = gen.rrand(accs, opt_acc_sets.max);
 
           spot::acc_cond::acc_code code;
           if (opt_acceptance)
             {
-              code = spot::acc_cond::acc_code(opt_acceptance);
+              code = spot::acc_cond::acc_code(opt_acceptance, gen);
               accs = code.used_sets().max_set();
               if (opt_colored && accs == 0)
                 error(2, 0, "--colored requires at least one acceptance set; "
@@ -366,7 +417,7 @@ main(int argc, char** argv)
             }
 
           auto aut =
-            spot::random_graph(size, opt_density, &opt->aprops, d,
+            spot::random_graph(gen, size, opt_density, &opt->aprops, d,
                                accs, opt_acc_prob, 0.5,
                                opt_deterministic, opt_state_acc,
                                opt_colored);
@@ -396,9 +447,7 @@ main(int argc, char** argv)
           printer.print(aut, timer, nullptr,
                         opt_seed_str, automaton_num, nullptr);
 
-          ++automaton_num;
-          if (opt_automata > 0 && automaton_num >= opt_automata)
-            break;
+          automaton_num += automaton_step;
         }
       return 0;
     });
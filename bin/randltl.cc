@@ -24,6 +24,7 @@
 #include <argp.h>
 #include <cstdlib>
 #include <iterator>
+#include <limits>
 #include "error.h"
 
 #include "common_setup.hh"
@@ -69,6 +70,7 @@ enum {
   OPT_SEED,
   OPT_SERE_PRIORITIES,
   OPT_TREE_SIZE,
+  OPT_UNIQUE_FILTER,
   OPT_WF,
 };
 
@@ -94,6 +96,11 @@ static const argp_option options[] =
       "trivial simplifications (15)", 0 },
     { "allow-dups", OPT_DUPS, nullptr, 0,
       "allow duplicate formulas to be output", 0 },
+    { "unique-filter", OPT_UNIQUE_FILTER, "MB", 0,
+      "detect duplicate formulas using a Bloom filter of MB megabytes "
+      "instead of remembering all output formulas, so that memory stays "
+      "bounded; a few formulas that were never output may then be "
+      "skipped", 0 },
     DECLARE_OPT_R,
     RANGE_DOC,
     LEVEL_DOC(3),
@@ -153,6 +160,7 @@ static int opt_formulas = 1;
 static int opt_seed = 0;
 static range opt_tree_size = { 15, 15 };
 static bool opt_unique = true;
+static int opt_unique_filter = 0;
 static bool opt_wf = false;
 static bool ap_count_given = false;
 
@@ -206,6 +214,14 @@ parse_opt(int key, char* arg, struct argp_state* as)
       if (opt_tree_size.min > opt_tree_size.max)
         std::swap(opt_tree_size.min, opt_tree_size.max);
       break;
+    case OPT_UNIQUE_FILTER:
+      opt_unique_filter = to_pos_int(arg, "--unique-filter");
+      // The Bloom filter has 8 << 20 bits per megabyte.
+      if (size_t(opt_unique_filter)
+          > (std::numeric_limits<size_t>::max() >> 23))
+        error(2, 0, "--unique-filter: %d MB is too large",
+              opt_unique_filter);
+      break;
     case OPT_WF:
       opt_wf = true;
       break;
@@ -271,6 +287,7 @@ main(int argc, char** argv)
           opts.set("seed", opt_seed);
           opts.set("simplification_level", simplification_level);
           opts.set("unique", opt_unique);
+          opts.set("unique_filter", opt_unique_filter);
           return opts;
         }(), opt_pL, opt_pS, opt_pB);
 
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2013-2019 Laboratoire de Recherche et Développement
+// Copyright (C) 2013-2020 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -44,9 +44,27 @@ static const argp_option options[] =
 (2) additionally allows automata-based implication checks, (3) enables \
 more rules based on automata-based implication checks.  The default value \
 depends on the --low, --medium, or --high settings.") },
+    { DOC("tls-wide", "If set to N>0, n-ary conjunctions or disjunctions \
+with more than N operands are only simplified using implications between \
+pairs of operands that share some atomic proposition.  This loses some \
+rewritings, but scales to formulas with thousands of operands.  The \
+default (0) always checks each operand against all the other ones.") },
+    { DOC("tls-cache-size", "If set to N>0, the caches of the simplifier \
+are limited to about N kilobytes, evicting the least recently used \
+entries.  This is mostly useful when many formulas are translated by \
+the same process.  The default (0) does not limit the caches.") },
     { nullptr, 0, nullptr, 0, "Translation options:", 0 },
     { DOC("ltl-split", "Set to 0 to disable the translation of automata \
-as product or sum of subformulas.") },
+as product or sum of subformulas.  Set to 2 to additionally split the \
+conjuncts that are not obligations or suspendable into groups that share \
+no atomic propositions, and to combine all the separately translated \
+automata by always multiplying the two smallest ones first, simplifying \
+each intermediate product.  The time spent translating each part \
+can be displayed with the %o sequence of --stats.") },
+    { DOC("fm-cache", "Set to 1 to share the translations of subformulas \
+(and of SERE operands) between all the formulas translated by the same \
+process.  This speeds up the translation of formulas with many common \
+subformulas, at the cost of memory that is only released at the end.") },
     { DOC("comp-susp", "Set to 1 to enable compositional suspension, \
 as described in our SPIN'13 paper (see Bibliography below).  Set to 2, \
 to build only the skeleton TGBA without composing it.  Set to 0 (the \
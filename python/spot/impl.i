@@ -159,6 +159,7 @@
 #include <spot/twaalgos/dtwasat.hh>
 #include <spot/twaalgos/relabel.hh>
 #include <spot/twaalgos/word.hh>
+#include <spot/twaalgos/wordcheck.hh>
 #include <spot/twaalgos/are_isomorphic.hh>
 #include <spot/twaalgos/rabin2parity.hh>
 #include <spot/twaalgos/toparity.hh>
@@ -679,6 +680,7 @@ def state_is_accepting(self, src) -> "bool":
 %include <spot/twaalgos/dtwasat.hh>
 %include <spot/twaalgos/relabel.hh>
 %include <spot/twaalgos/word.hh>
+%include <spot/twaalgos/wordcheck.hh>
 %template(list_bdd) std::list<bdd>;
 %include <spot/twaalgos/are_isomorphic.hh>
 %include <spot/twaalgos/rabin2parity.hh>
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2014-2018 Laboratoire de Recherche et
+// Copyright (C) 2014-2018, 2020 Laboratoire de Recherche et
 // Développement de l'Epita.
 //
 // This file is part of Spot, a model checking library.
@@ -20,6 +20,7 @@
 #pragma once
 
 #include <spot/misc/common.hh>
+#include <spot/misc/parallel.hh>
 #include <vector>
 #include <type_traits>
 #include <tuple>
@@ -1225,27 +1226,164 @@ namespace spot
       killed_edge_ = 0;
     }
 
+  private:
+    // Number of chunks into which \a nedges edges should be split to
+    // be processed in parallel according to \a ppolicy.  Each chunk
+    // has at least 32768 edges, so graphs with fewer than 65536
+    // edges are not worth starting threads, and get a single chunk.
+    static unsigned edge_chunks_(parallel_policy ppolicy, unsigned nedges)
+    {
+      unsigned n = std::min(ppolicy.nthreads(), nedges / (1U << 15));
+      return n ? n : 1;
+    }
+
+  public:
     /// \brief Sort all edges according to a predicate
     ///
     /// This will invalidate all iterators, and also destroy edge
     /// chains.  Call chain_edges_() immediately afterwards unless you
     /// know what you are doing.
+    ///
+    /// On large graphs, \a ppolicy allows to sort chunks of the
+    /// edges in parallel, and then to merge them.  The result is the
+    /// same as with a single thread.  However \a p is then called
+    /// from several threads at once, so it should not create or
+    /// destroy BDDs (as bdd_less_than_stable does), since BuDDy is
+    /// not thread-safe.
     template<class Predicate = std::less<edge_storage_t>>
-    void sort_edges_(Predicate p = Predicate())
+    void sort_edges_(Predicate p = Predicate(),
+                     parallel_policy ppolicy = parallel_policy())
     {
       //std::cerr << "\nbefore\n";
       //dump_storage(std::cerr);
-      std::stable_sort(edges_.begin() + 1, edges_.end(), p);
+      unsigned nedges = edges_.size() - 1;
+      unsigned nchunks = edge_chunks_(ppolicy, nedges);
+      if (nchunks == 1)
+        {
+          std::stable_sort(edges_.begin() + 1, edges_.end(), p);
+          return;
+        }
+      // Stably sort each chunk, and then merge neighboring chunks,
+      // as in a bottom-up merge sort.
+      std::vector<edge> bounds(nchunks + 1);
+      for (unsigned i = 0; i <= nchunks; ++i)
+        bounds[i] = 1 + (unsigned long long) nedges * i / nchunks;
+      auto b = edges_.begin();
+      parallel_for(ppolicy, nchunks, [&](unsigned i, unsigned) noexcept
+                   {
+                     std::stable_sort(b + bounds[i], b + bounds[i + 1], p);
+                   });
+      for (unsigned w = 1; w < nchunks; w *= 2)
+        parallel_for(ppolicy, (nchunks + w - 1) / (2 * w),
+                     [&](unsigned j, unsigned) noexcept
+                     {
+                       unsigned lo = 2 * w * j;
+                       unsigned mid = lo + w;
+                       unsigned hi = std::min(mid + w, nchunks);
+                       std::inplace_merge(b + bounds[lo], b + bounds[mid],
+                                          b + bounds[hi], p);
+                     });
+    }
+
+    /// \brief Sort all edges by source, and then according to a
+    /// predicate
+    ///
+    /// This has the same effect as sort_edges_() with a predicate
+    /// that compares the sources of the edges first.  However the
+    /// edges are first distributed according to their sources in
+    /// linear time (unless they are already grouped by sources), and
+    /// \a p is only used to stably sort the edges leaving each state.
+    /// This is faster than sort_edges_() on large graphs, where
+    /// most states have few successors.
+    ///
+    /// As for sort_edges_(), this will invalidate all iterators and
+    /// destroy edge chains.  Call chain_edges_() immediately
+    /// afterwards unless you know what you are doing.  Also, \a
+    /// ppolicy allows to sort the successors of different states in
+    /// parallel on large graphs, in which case \a p should not create
+    /// or destroy BDDs.
+    template<class Predicate = std::less<edge_storage_t>>
+    void sort_edges_srcfirst_(Predicate p = Predicate(),
+                              parallel_policy ppolicy = parallel_policy())
+    {
+      unsigned ns = states_.size();
+      unsigned tend = edges_.size();
+      // start[s] is the index of the first edge leaving s in the
+      // sorted vector, and start[s + 1] is its end.
+      std::vector<unsigned> start(ns + 1, 0);
+      bool grouped = true;
+      for (edge t = 1; t < tend; ++t)
+        {
+          state src = edges_[t].src;
+          grouped &= t == 1 || edges_[t - 1].src <= src;
+          ++start[src + 1];
+        }
+      start[0] = 1;
+      for (state s = 0; s < ns; ++s)
+        start[s + 1] += start[s];
+
+      if (!grouped)
+        {
+          std::vector<unsigned> order(tend);
+          {
+            std::vector<unsigned> pos(start.begin(), start.end() - 1);
+            for (edge t = 1; t < tend; ++t)
+              order[pos[edges_[t].src]++] = t;
+          }
+          edge_vector_t sorted;
+          sorted.reserve(tend);
+          sorted.emplace_back(std::move(edges_[0]));
+          for (edge t = 1; t < tend; ++t)
+            sorted.emplace_back(std::move(edges_[order[t]]));
+          std::swap(edges_, sorted);
+        }
+
+      auto sort_states = [&](state sbeg, state send)
+        {
+          for (state s = sbeg; s < send; ++s)
+            if (start[s + 1] - start[s] > 1)
+              std::stable_sort(edges_.begin() + start[s],
+                               edges_.begin() + start[s + 1], p);
+        };
+      unsigned nedges = tend - 1;
+      unsigned nchunks = edge_chunks_(ppolicy, nedges);
+      if (nchunks == 1)
+        {
+          sort_states(0, ns);
+          return;
+        }
+      // Give each chunk the states whose successors start in a range
+      // of about nedges/nchunks edges.
+      std::vector<state> bounds(nchunks + 1);
+      for (unsigned i = 0; i < nchunks; ++i)
+        bounds[i] =
+          std::lower_bound(start.begin(), start.end() - 1,
+                           1 + (unsigned long long) nedges * i / nchunks)
+          - start.begin();
+      bounds[nchunks] = ns;
+      parallel_for(ppolicy, nchunks, [&](unsigned i, unsigned) noexcept
+                   {
+                     sort_states(bounds[i], bounds[i + 1]);
+                   });
     }
 
     /// \brief Reconstruct the chain of outgoing edges
     ///
     /// Should be called only when it is known that all edges
     /// with the same destination are consecutive in the vector.
-    void chain_edges_()
+    ///
+    /// On large graphs, \a ppolicy allows to rechain different
+    /// ranges of edges in parallel.
+    void chain_edges_(parallel_policy ppolicy = parallel_policy())
     {
-      state last_src = -1U;
       edge tend = edges_.size();
+      unsigned nchunks = edge_chunks_(ppolicy, tend - 1);
+      if (nchunks > 1)
+        {
+          chain_edges_parallel_(ppolicy, nchunks);
+          return;
+        }
+      state last_src = -1U;
       for (edge t = 1; t < tend; ++t)
         {
           state src = edges_[t].src;
@@ -1283,6 +1421,67 @@ namespace spot
       //dump_storage(std::cerr);
     }
 
+  private:
+    void chain_edges_parallel_(parallel_policy ppolicy, unsigned nchunks)
+    {
+      // Split the edges into chunks that do not separate edges with
+      // the same source.  A state is updated by the chunk holding its
+      // successors, or, if it has none, by the chunk holding the
+      // successors of the next state that has some (or by the last
+      // chunk).  So no state is updated by two threads.
+      edge tend = edges_.size();
+      std::vector<edge> bounds(nchunks + 1);
+      bounds[0] = 1;
+      for (unsigned i = 1; i < nchunks; ++i)
+        {
+          edge b = std::max<edge>(bounds[i - 1],
+                                  1 + (unsigned long long) (tend - 1)
+                                  * i / nchunks);
+          while (b < tend && edges_[b].src == edges_[b - 1].src)
+            ++b;
+          bounds[i] = b;
+        }
+      bounds[nchunks] = tend;
+      state send = states_.size();
+      parallel_for(ppolicy, nchunks, [&](unsigned i, unsigned) noexcept
+        {
+          edge lo = bounds[i];
+          edge hi = bounds[i + 1];
+          // The last state with successors in the previous chunks.
+          state last_src = lo > 1 ? edges_[lo - 1].src : -1U;
+          for (edge t = lo; t < hi; ++t)
+            {
+              state src = edges_[t].src;
+              if (src != last_src)
+                {
+                  while (++last_src != src)
+                    {
+                      states_[last_src].succ = 0;
+                      states_[last_src].succ_tail = 0;
+                    }
+                  states_[src].succ = t;
+                }
+              if (t + 1 < hi && edges_[t + 1].src == src)
+                {
+                  edges_[t].next_succ = t + 1;
+                }
+              else
+                {
+                  states_[src].succ_tail = t;
+                  edges_[t].next_succ = 0;
+                }
+            }
+          if (i == nchunks - 1)
+            while (++last_src != send)
+              {
+                states_[last_src].succ = 0;
+                states_[last_src].succ_tail = 0;
+              }
+        });
+    }
+
+  public:
+
     /// \brief Rename all the states in the edge vector.
     ///
     /// The edges_ vector is left in a state that is incorrect and
@@ -1370,5 +1569,56 @@ namespace spot
       //std::cerr << "\nafter defrag\n";
       //dump_storage(std::cerr);
     }
+
+    /// \brief Rename and remove states, without maintaining the
+    /// chains of successors.
+    ///
+    /// This has the same arguments as defrag_states(), and also
+    /// preserves the relative order of the remaining edges in the
+    /// edges_ vector.  However the edges are not renumbered, so
+    /// everything is done in a single pass over the edges_ vector,
+    /// without allocating any map.  The edges_ vector is left in a
+    /// state that is incorrect and should eventually be fixed by a
+    /// call to chain_edges_() (usually after sort_edges_()) before
+    /// any iteration on the successor of a state is performed.
+    void defrag_states_unchained_(const std::vector<unsigned>& newst,
+                                  unsigned used_states)
+    {
+      SPOT_ASSERT(newst.size() >= states_.size());
+      SPOT_ASSERT(used_states > 0);
+
+      unsigned send = states_.size();
+      for (state s = 0; s < send; ++s)
+        {
+          state dst = newst[s];
+          if (dst == s || dst == -1U)
+            continue;
+          states_[dst] = std::move(states_[s]);
+        }
+      states_.resize(used_states);
+
+      // Drop the dead edges and the edges leaving erased states,
+      // and rename the others.
+      unsigned tend = edges_.size();
+      unsigned dest = 1;
+      for (edge t = 1; t < tend; ++t)
+        {
+          if (is_dead_edge(t))
+            continue;
+          state src = newst[edges_[t].src];
+          if (src == -1U)
+            continue;
+          auto& tr = edges_[dest];
+          if (t != dest)
+            tr = std::move(edges_[t]);
+          tr.src = src;
+          tr.dst = newst[tr.dst];
+          // Make sure no edge looks dead until the chains are rebuilt.
+          tr.next_succ = 0;
+          ++dest;
+        }
+      edges_.resize(dest);
+      killed_edge_ = 0;
+    }
   };
 }
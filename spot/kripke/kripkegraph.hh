@@ -239,6 +239,41 @@ namespace spot
 
     }
 
+#ifndef SWIG
+    virtual void
+    succ_batch(const spot::state* st,
+               std::vector<twa_succ_record>& out) const override
+    {
+      auto s = down_cast<const typename graph_t::state_storage_t*>(st);
+      SPOT_ASSERT(!s->succ || g_.is_valid_edge(s->succ));
+      bdd cond = s->cond();
+      for (unsigned t = s->succ; t; t = g_.edge_storage(t).next_succ)
+        out.push_back({&g_.state_data(g_.edge_storage(t).dst), cond, {}});
+    }
+
+    virtual bool has_native_succ_batch() const override
+    {
+      return true;
+    }
+
+    virtual unsigned packed_state_words() const override
+    {
+      return 1;
+    }
+
+    virtual void
+    pack_state(const spot::state* st, std::uint64_t* out) const override
+    {
+      *out = state_number(st);
+    }
+
+    virtual const spot::state*
+    unpack_state(const std::uint64_t* in) const override
+    {
+      return state_from_number(*in);
+    }
+#endif
+
     state_num
     state_number(const state* st) const
     {
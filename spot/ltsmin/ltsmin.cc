@@ -700,25 +700,31 @@ namespace spot
         delete state_condition_last_cc_; // Might be 0 already.
       }
 
+      // Build a compressed state from the values of its variables.
+      spins_compressed_state* make_compressed_state(const int* vars) const
+      {
+        size_t csize = state_size_ * 2;
+        compress_(vars, state_size_, compressed_, csize);
+
+        multiple_size_pool* p =
+          const_cast<multiple_size_pool*>(&compstatepool_);
+        void* mem = p->allocate(sizeof(spins_compressed_state)
+                                - sizeof(spins_compressed_state::vars)
+                                + sizeof(int) * csize);
+        spins_compressed_state* res = new(mem)
+          spins_compressed_state(csize, p);
+        SPOT_ASSUME(res != nullptr);
+        memcpy(res->vars, compressed_, csize * sizeof(int));
+        res->compute_hash();
+        return res;
+      }
+
       virtual state* get_init_state() const override
       {
         if (compress_)
           {
             d_->get_initial_state(uncompressed_);
-            size_t csize = state_size_ * 2;
-            compress_(uncompressed_, state_size_, compressed_, csize);
-
-            multiple_size_pool* p =
-              const_cast<multiple_size_pool*>(&compstatepool_);
-            void* mem = p->allocate(sizeof(spins_compressed_state)
-                                    - sizeof(spins_compressed_state::vars)
-                                    + sizeof(int) * csize);
-            spins_compressed_state* res = new(mem)
-              spins_compressed_state(csize, p);
-            SPOT_ASSUME(res != nullptr);
-            memcpy(res->vars, compressed_, csize * sizeof(int));
-            res->compute_hash();
-            return res;
+            return make_compressed_state(uncompressed_);
           }
         else
           {
@@ -851,17 +857,15 @@ namespace spot
       }
 
 
-      virtual
-      spins_succ_iterator* succ_iter(const state* st) const override
+      // Compute the successors of ST, whose condition is SCOND.
+      // The result is owned by the caller.
+      callback_context* succ_cc(const state* st, const bdd& scond) const
       {
-        // This may also compute successors in state_condition_last_cc
-        bdd scond = compute_state_condition(st);
-
         callback_context* cc;
         if (state_condition_last_cc_)
           {
             cc = state_condition_last_cc_;
-            state_condition_last_cc_ = nullptr; // Now owned by the iterator.
+            state_condition_last_cc_ = nullptr; // Now owned by the caller.
           }
         else
           {
@@ -872,6 +876,15 @@ namespace spot
             if (t == 0 && scond != bddfalse)
               cc->transitions.emplace_back(st->clone());
           }
+        return cc;
+      }
+
+      virtual
+      spins_succ_iterator* succ_iter(const state* st) const override
+      {
+        // This may also compute successors in state_condition_last_cc
+        bdd scond = compute_state_condition(st);
+        callback_context* cc = succ_cc(st, scond);
 
         if (iter_cache_)
           {
@@ -884,6 +897,61 @@ namespace spot
         return new spins_succ_iterator(cc, scond);
       }
 
+      virtual void
+      succ_batch(const state* st,
+                 std::vector<twa_succ_record>& out) const override
+      {
+        bdd scond = compute_state_condition(st);
+        callback_context* cc = succ_cc(st, scond);
+        // Hand the successors over to OUT, instead of cloning them.
+        for (auto t: cc->transitions)
+          out.push_back({t, scond, {}});
+        cc->transitions.clear();
+        delete cc;
+      }
+
+      virtual bool has_native_succ_batch() const override
+      {
+        return true;
+      }
+
+      // The packed representation of a state stores the values of
+      // its (uncompressed) variables, two per word.
+      virtual unsigned packed_state_words() const override
+      {
+        return (state_size_ + 1) / 2;
+      }
+
+      virtual void
+      pack_state(const state* st, std::uint64_t* out) const override
+      {
+        const int* vars = get_vars(st);
+        memset(out, 0, packed_state_words() * sizeof(*out));
+        for (int i = 0; i < state_size_; ++i)
+          out[i / 2] |= std::uint64_t(unsigned(vars[i])) << (32 * (i % 2));
+      }
+
+      virtual const state*
+      unpack_state(const std::uint64_t* in) const override
+      {
+        auto unpack_vars = [&](int* vars)
+          {
+            for (int i = 0; i < state_size_; ++i)
+              vars[i] = int(unsigned(in[i / 2] >> (32 * (i % 2))));
+          };
+        if (compress_)
+          {
+            unpack_vars(uncompressed_);
+            return make_compressed_state(uncompressed_);
+          }
+        fixed_size_pool* p = const_cast<fixed_size_pool*>(&statepool_);
+        spins_state* res = new(p->allocate()) spins_state(state_size_, p);
+        SPOT_ASSUME(res != nullptr);
+        unpack_vars(res->vars);
+        res->compute_hash();
+        return res;
+      }
+
       virtual
       bdd state_condition(const state* st) const override
       {
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2018 Laboratoire de Recherche et Développement
+// Copyright (C) 2018, 2020 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -19,7 +19,13 @@
 
 #include "config.h"
 #include <spot/misc/bitset.hh>
+#include <algorithm>
+#include <atomic>
 #include <stdexcept>
+#include <unordered_set>
+#ifdef ENABLE_PTHREAD
+#  include <mutex>
+#endif
 
 namespace spot
 {
@@ -34,5 +40,114 @@ namespace spot
     {
       throw std::runtime_error("bit index is out of bounds");
     }
+
+    namespace
+    {
+      // The values of wide_bitset<N> are stored in chunks that never
+      // move, so that they can be read without locking.  They are
+      // never freed, since marks may be used until the very end of
+      // the program.  There is one such table per number of words.
+      constexpr unsigned chunk_bits = 12;
+      constexpr unsigned chunk_size = 1U << chunk_bits;
+      constexpr unsigned max_chunks = 1U << 16;
+      constexpr unsigned max_words = 1U << 10;
+
+      class wide_table
+      {
+        struct hash
+        {
+          const wide_table* t;
+          size_t operator()(unsigned num) const
+          {
+            const unsigned* w = t->words(num);
+            return fnv_hash(w, w + t->n_);
+          }
+        };
+        struct equal
+        {
+          const wide_table* t;
+          bool operator()(unsigned a, unsigned b) const
+          {
+            const unsigned* wa = t->words(a);
+            return std::equal(wa, wa + t->n_, t->words(b));
+          }
+        };
+
+        const unsigned n_;      // Words per value.
+        unsigned count_ = 0;    // Number of values.
+        std::atomic<unsigned*> chunks_[max_chunks];
+        std::unordered_set<unsigned, hash, equal> index_;
+#ifdef ENABLE_PTHREAD
+        std::mutex mutex_;
+#endif
+
+      public:
+        explicit wide_table(unsigned n)
+          : n_(n), chunks_{}, index_(0, hash{this}, equal{this})
+        {
+        }
+
+        const unsigned*
+        words(unsigned num) const
+        {
+          return chunks_[num >> chunk_bits].load(std::memory_order_acquire)
+            + (num & (chunk_size - 1)) * n_;
+        }
+
+        unsigned
+        intern(const unsigned* words)
+        {
+#ifdef ENABLE_PTHREAD
+          std::lock_guard<std::mutex> lock(mutex_);
+#endif
+          if (SPOT_UNLIKELY(count_ == chunk_size * max_chunks))
+            throw std::runtime_error("too many distinct wide_bitset values");
+          // Store the value in the first free slot, then check
+          // whether it is already known.
+          auto& chunk = chunks_[count_ >> chunk_bits];
+          unsigned* c = chunk.load(std::memory_order_relaxed);
+          if (!c)
+            {
+              c = new unsigned[chunk_size * n_];
+              chunk.store(c, std::memory_order_release);
+            }
+          std::copy(words, words + n_, c + (count_ & (chunk_size - 1)) * n_);
+          auto p = index_.insert(count_);
+          if (p.second)
+            ++count_;
+          return *p.first;
+        }
+      };
+
+      std::atomic<wide_table*> tables[max_words];
+
+      wide_table&
+      table(unsigned n)
+      {
+        if (SPOT_UNLIKELY(n == 0 || n > max_words))
+          throw std::runtime_error("unsupported wide_bitset size");
+        wide_table* t = tables[n - 1].load(std::memory_order_acquire);
+        if (SPOT_UNLIKELY(!t))
+          {
+            auto* nt = new wide_table(n);
+            if (tables[n - 1].compare_exchange_strong
+                (t, nt, std::memory_order_acq_rel))
+              t = nt;
+            else
+              delete nt;
+          }
+        return *t;
+      }
+    }
+
+    unsigned wide_bitset_intern(const unsigned* words, unsigned n)
+    {
+      return table(n).intern(words);
+    }
+
+    const unsigned* wide_bitset_words(unsigned num, unsigned n)
+    {
+      return table(n).words(num);
+    }
   }
 }
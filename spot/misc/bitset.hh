@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2018 Laboratoire de Recherche et Développement
+// Copyright (C) 2018, 2020 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -19,7 +19,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
 #include <spot/misc/hashfunc.hh>
 #include <spot/misc/common.hh>
 
@@ -30,12 +32,24 @@ namespace spot
   {
     [[noreturn]] SPOT_API void report_bit_shift_too_big();
     [[noreturn]] SPOT_API void report_bit_out_of_bounds();
+
+    // Hash-consing of the values of wide_bitset that do not fit in
+    // 63 bits.  wide_bitset_intern() returns the number of the
+    // unique copy of the \a n words at \a words, and
+    // wide_bitset_words() returns the words of such a copy.
+    SPOT_API unsigned wide_bitset_intern(const unsigned* words, unsigned n);
+    SPOT_API const unsigned* wide_bitset_words(unsigned num, unsigned n);
   }
 #endif
 
+  template<size_t N>
+  class wide_bitset;
+
   template<size_t N>
   class SPOT_API bitset
   {
+    friend class wide_bitset<N>;
+
     using word_t = unsigned;
     // the number of bits must hold on an unsigned
     static_assert(8*N*sizeof(word_t) < -1U, "too many bits in bitset");
@@ -95,6 +109,18 @@ namespace spot
       return !this->operator==(other);
     }
 
+    /// \brief Whether all bits set in *this are also set in \a other.
+    ///
+    /// This loop has no branch and does not build any temporary
+    /// bitset, so that compilers can vectorize it when N is large.
+    bool subset(const bitset& other) const
+    {
+      word_t res = 0;
+      for (unsigned i = 0; i != N; ++i)
+        res |= data[i] & ~other.data[i];
+      return !res;
+    }
+
     bool operator<(const bitset& other) const
     {
       for (unsigned i = 0; i != N; ++i)
@@ -136,6 +162,17 @@ namespace spot
       data[s / (8*sizeof(word_t))] |= 1U << (s % (8*sizeof(word_t)));
     }
 
+    bool test(unsigned s) const
+    {
+#if SPOT_DEBUG || defined(SWIGPYTHON)
+      if (SPOT_UNLIKELY(s >= 8 * N * sizeof(word_t)))
+        internal::report_bit_out_of_bounds();
+#else
+      SPOT_ASSUME(s < 8 * N * sizeof(word_t));
+#endif
+      return (data[s / (8*sizeof(word_t))] >> (s % (8*sizeof(word_t)))) & 1U;
+    }
+
     void clear(unsigned s)
     {
 #if SPOT_DEBUG || defined(SWIGPYTHON)
@@ -288,6 +325,15 @@ namespace spot
       return *this;
     }
 
+    /// \brief The bits set in *this but not in \a other.
+    bitset andnot(const bitset& other) const
+    {
+      bitset r = *this;
+      for (unsigned i = 0; i != N; ++i)
+        r.data[i] &= ~other.data[i];
+      return r;
+    }
+
     bitset operator-(word_t s) const
     {
       bitset r = *this;
@@ -398,8 +444,382 @@ namespace spot
         }
       return 0;
     }
+
+    /// \brief The position of the lowest bit set at position \a s or
+    /// above, or the number of bits if there is none.
+    unsigned lowest_from(unsigned s) const
+    {
+      const unsigned wbits = 8 * sizeof(word_t);
+      unsigned i = s / wbits;
+      if (i >= N)
+        return N * wbits;
+      word_t v = data[i] & (-1U << (s % wbits));
+      while (v == 0)
+        {
+          if (++i == N)
+            return N * wbits;
+          v = data[i];
+        }
+#ifdef __GNUC__
+      return i * wbits + __builtin_ctz(v);
+#else
+      unsigned res = i * wbits;
+      while ((v & 1) == 0)
+        {
+          ++res;
+          v >>= 1;
+        }
+      return res;
+#endif
+    }
   };
 
+  /// \brief A bitset of 32*N bits that stores small values inline.
+  ///
+  /// This is a 64-bit value.  Values whose bits are all below 63
+  /// are stored directly in it, so that the operations on them only
+  /// take a few instructions.  Larger values are hash-consed in a
+  /// global table that keeps them as arrays of N words, and are
+  /// represented by their number in this table; operations on them
+  /// are performed on bitset<N>.  Because the table has a single
+  /// copy of each value, equal values have equal representations.
+  ///
+  /// This class is trivially copyable, as required by
+  /// acc_cond::mark_t, which uses it when Spot is configured with
+  /// --enable-wide-marks.  The price to pay is that every large
+  /// value ever computed stays in the table until the program exits.
+  template<size_t N>
+  class SPOT_API wide_bitset
+  {
+    using word_t = unsigned;
+    using value_t = bitset<N>;
+    static_assert(sizeof(word_t) == 4, "wide_bitset assumes 32-bit words");
+    static constexpr unsigned bits_ = 8 * N * sizeof(word_t);
+    // Number of bits that can be stored inline.
+    static constexpr unsigned inline_bits_ = bits_ < 63 ? bits_ : 63;
+    static constexpr std::uint64_t spilled_ = std::uint64_t(1) << 63;
+
+    std::uint64_t v_;
+
+    constexpr explicit wide_bitset(std::uint64_t v)
+      : v_(v)
+    {
+    }
+
+    bool is_inline() const
+    {
+      return !(v_ & spilled_);
+    }
+
+    bool both_inline(const wide_bitset& other) const
+    {
+      return !((v_ | other.v_) & spilled_);
+    }
+
+    value_t expand() const
+    {
+      value_t res = value_t::zero();
+      if (is_inline())
+        {
+          res.data[0] = static_cast<word_t>(v_);
+          if (N > 1)
+            res.data[N > 1] = static_cast<word_t>(v_ >> 32);
+        }
+      else
+        {
+          const word_t* w =
+            internal::wide_bitset_words(static_cast<unsigned>(v_), N);
+          std::copy(w, w + N, res.data.begin());
+        }
+      return res;
+    }
+
+    static wide_bitset pack(const value_t& b)
+    {
+      std::uint64_t low = b.data[0];
+      if (N > 1)
+        low |= std::uint64_t(b.data[N > 1]) << 32;
+      bool fits = !(low & spilled_);
+      for (unsigned i = 2; fits && i < N; ++i)
+        fits = !b.data[i];
+      if (fits)
+        return wide_bitset(low);
+      return wide_bitset(spilled_
+                         | internal::wide_bitset_intern(b.data.data(), N));
+    }
+
+  public:
+    wide_bitset() = default;
+    ~wide_bitset() = default;
+
+    static constexpr wide_bitset zero() { return wide_bitset(0ULL); }
+    static constexpr wide_bitset one() { return wide_bitset(1ULL); }
+    static wide_bitset mone() { return pack(value_t::mone()); }
+
+    explicit operator bool() const
+    {
+      return v_;
+    }
+
+    size_t hash() const
+    {
+      return fnv_hash(&v_, &v_ + 1);
+    }
+
+    bool operator==(const wide_bitset& other) const
+    {
+      return v_ == other.v_;
+    }
+
+    bool operator!=(const wide_bitset& other) const
+    {
+      return v_ != other.v_;
+    }
+
+    bool subset(const wide_bitset& other) const
+    {
+      if (both_inline(other))
+        return !(v_ & ~other.v_);
+      return expand().subset(other.expand());
+    }
+
+    // Same order as bitset<N>, where the lowest word is the most
+    // significant.
+    bool operator<(const wide_bitset& other) const
+    {
+      if (both_inline(other))
+        {
+          auto l = static_cast<word_t>(v_);
+          auto ol = static_cast<word_t>(other.v_);
+          if (l != ol)
+            return l < ol;
+          return (v_ >> 32) < (other.v_ >> 32);
+        }
+      return expand() < other.expand();
+    }
+
+    bool operator<=(const wide_bitset& other) const
+    {
+      return !other.operator<(*this);
+    }
+
+    bool operator>(const wide_bitset& other) const
+    {
+      return other.operator<(*this);
+    }
+
+    bool operator>=(const wide_bitset& other) const
+    {
+      return !this->operator<(other);
+    }
+
+    void set(unsigned s)
+    {
+      if (is_inline() && s < inline_bits_)
+        {
+          v_ |= std::uint64_t(1) << s;
+          return;
+        }
+      value_t r = expand();
+      r.set(s);
+      *this = pack(r);
+    }
+
+    bool test(unsigned s) const
+    {
+      if (is_inline() && s < inline_bits_)
+        return (v_ >> s) & 1;
+      return expand().test(s);
+    }
+
+    void clear(unsigned s)
+    {
+      if (is_inline() && s < inline_bits_)
+        {
+          v_ &= ~(std::uint64_t(1) << s);
+          return;
+        }
+      value_t r = expand();
+      r.clear(s);
+      *this = pack(r);
+    }
+
+    wide_bitset operator<<(unsigned s) const
+    {
+      wide_bitset r = *this;
+      r <<= s;
+      return r;
+    }
+
+    wide_bitset operator>>(unsigned s) const
+    {
+      wide_bitset r = *this;
+      r >>= s;
+      return r;
+    }
+
+    wide_bitset& operator<<=(unsigned s)
+    {
+      if (is_inline() && s < inline_bits_ && !(v_ >> (inline_bits_ - s)))
+        {
+          v_ <<= s;
+          return *this;
+        }
+      *this = pack(expand() << s);
+      return *this;
+    }
+
+    wide_bitset& operator>>=(unsigned s)
+    {
+      if (is_inline() && s < inline_bits_)
+        {
+          v_ >>= s;
+          return *this;
+        }
+      *this = pack(expand() >> s);
+      return *this;
+    }
+
+    wide_bitset operator~() const
+    {
+      return pack(~expand());
+    }
+
+    wide_bitset operator&(const wide_bitset& other) const
+    {
+      wide_bitset r = *this;
+      r &= other;
+      return r;
+    }
+
+    wide_bitset operator|(const wide_bitset& other) const
+    {
+      wide_bitset r = *this;
+      r |= other;
+      return r;
+    }
+
+    wide_bitset operator^(const wide_bitset& other) const
+    {
+      wide_bitset r = *this;
+      r ^= other;
+      return r;
+    }
+
+    wide_bitset& operator&=(const wide_bitset& other)
+    {
+      if (both_inline(other))
+        v_ &= other.v_;
+      else
+        *this = pack(expand() & other.expand());
+      return *this;
+    }
+
+    wide_bitset& operator|=(const wide_bitset& other)
+    {
+      if (both_inline(other))
+        v_ |= other.v_;
+      else
+        *this = pack(expand() | other.expand());
+      return *this;
+    }
+
+    wide_bitset& operator^=(const wide_bitset& other)
+    {
+      if (both_inline(other))
+        v_ ^= other.v_;
+      else
+        *this = pack(expand() ^ other.expand());
+      return *this;
+    }
+
+    wide_bitset andnot(const wide_bitset& other) const
+    {
+      if (both_inline(other))
+        return wide_bitset(v_ & ~other.v_);
+      return pack(expand().andnot(other.expand()));
+    }
+
+    wide_bitset operator-(word_t s) const
+    {
+      wide_bitset r = *this;
+      r -= s;
+      return r;
+    }
+
+    wide_bitset& operator-=(word_t s)
+    {
+      if (is_inline() && v_ >= s)
+        v_ -= s;
+      else
+        *this = pack(expand() - s);
+      return *this;
+    }
+
+    wide_bitset operator-() const
+    {
+      return pack(-expand());
+    }
+
+    unsigned count() const
+    {
+      if (!is_inline())
+        return expand().count();
+#ifdef __GNUC__
+      return __builtin_popcountll(v_);
+#else
+      unsigned c = 0U;
+      for (std::uint64_t v = v_; v; v &= v - 1)
+        ++c;
+      return c;
+#endif
+    }
+
+    unsigned highest() const
+    {
+      if (!is_inline())
+        return expand().highest();
+      if (!v_)
+        return 0;
+#ifdef __GNUC__
+      return 63 - __builtin_clzll(v_);
+#else
+      unsigned res = 0;
+      for (std::uint64_t v = v_ >> 1; v; v >>= 1)
+        ++res;
+      return res;
+#endif
+    }
+
+    unsigned lowest() const
+    {
+      if (!is_inline())
+        return expand().lowest();
+      return v_ ? lowest_from(0) : 0;
+    }
+
+    unsigned lowest_from(unsigned s) const
+    {
+      if (!is_inline())
+        return expand().lowest_from(s);
+      if (s >= inline_bits_)
+        return bits_;
+      std::uint64_t v = v_ & (~std::uint64_t(0) << s);
+      if (!v)
+        return bits_;
+#ifdef __GNUC__
+      return __builtin_ctzll(v);
+#else
+      unsigned res = 0;
+      while ((v & 1) == 0)
+        {
+          ++res;
+          v >>= 1;
+        }
+      return res;
+#endif
+    }
+  };
 }
 
 namespace std
@@ -412,4 +832,13 @@ namespace std
       return b.hash();
     }
   };
+
+  template<size_t N>
+  struct hash<spot::wide_bitset<N>>
+  {
+    size_t operator()(const spot::wide_bitset<N>& b) const
+    {
+      return b.hash();
+    }
+  };
 }
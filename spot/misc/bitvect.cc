@@ -84,8 +84,12 @@ namespace spot
     // Compute the number n of bits used in the last block.
     const size_t bpb = 8 * sizeof(bitvect::block_t);
     size_t n = size() % bpb;
-    // Use only the least n bits from storage_[i].
-    res ^= storage_[m-1] & ((1UL << n) - 1);
+    // Use only the least n bits from storage_[i].  (n == 0 means
+    // that the last block is fully used.)
+    block_t last = storage_[m-1];
+    if (n)
+      last &= (1UL << n) - 1;
+    res ^= last;
     return res;
   }
 
@@ -0,0 +1,111 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2020 Laboratoire de Recherche et Développement
+// de l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <spot/misc/common.hh>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace spot
+{
+  /// \ingroup misc_tools
+  /// \brief A Bloom filter.
+  ///
+  /// This is a set of fixed size that only remembers a few bits for
+  /// each inserted element.  Testing whether an element was inserted
+  /// never answers "no" for an inserted element, but may answer "yes"
+  /// for an element that was never inserted.  With \c k hash
+  /// functions and \c m bits per inserted element, the probability
+  /// of such a false positive is about
+  /// <code>(1-exp(-k/m))^k</code>, i.e., less than 1% for 10 bits
+  /// per element and the default of 7 hash functions.
+  ///
+  /// Elements are given by two independent hash values, from which
+  /// the \c k hash functions are derived by double hashing as
+  /// suggested by Kirsch and Mitzenmacher (ESA'06).
+  class SPOT_API bloom_filter
+  {
+  public:
+    /// \brief Create a filter of (at least) \a bits bits, using \a
+    /// hashes hash functions.
+    bloom_filter(size_t bits, unsigned hashes = 7)
+      : bits_(bits < 64 ? 64 : (bits + 63) / 64 * 64),
+        hashes_(hashes ? hashes : 1),
+        data_(bits_ / 64, 0)
+    {
+    }
+
+    /// \brief Insert the element whose hash values are \a h1 and \a h2.
+    ///
+    /// Return false if the element was (probably) already in the
+    /// filter, and true if it is new.
+    bool insert(size_t h1, size_t h2)
+    {
+      bool res = false;
+      std::uint64_t h = h1;
+      std::uint64_t step = h2 | 1;
+      for (unsigned i = 0; i < hashes_; ++i, h += step)
+        {
+          std::uint64_t b = h % bits_;
+          std::uint64_t mask = std::uint64_t(1) << (b % 64);
+          std::uint64_t& w = data_[b / 64];
+          if (!(w & mask))
+            {
+              w |= mask;
+              res = true;
+            }
+        }
+      return res;
+    }
+
+    /// \brief Whether the element whose hash values are \a h1 and \a
+    /// h2 was (probably) inserted.
+    bool contains(size_t h1, size_t h2) const
+    {
+      std::uint64_t h = h1;
+      std::uint64_t step = h2 | 1;
+      for (unsigned i = 0; i < hashes_; ++i, h += step)
+        {
+          std::uint64_t b = h % bits_;
+          if (!(data_[b / 64] & (std::uint64_t(1) << (b % 64))))
+            return false;
+        }
+      return true;
+    }
+
+    /// The number of bits of the filter.
+    size_t size() const
+    {
+      return bits_;
+    }
+
+    /// The number of hash functions.
+    unsigned hashes() const
+    {
+      return hashes_;
+    }
+
+  private:
+    size_t bits_;
+    unsigned hashes_;
+    std::vector<std::uint64_t> data_;
+  };
+}
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2013-2019 Laboratoire de Recherche et Développement
+// Copyright (C) 2013-2020 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -17,6 +17,7 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <spot/misc/_config.h>
 #include <cstdlib>
 #include <stdexcept>
 #include <cassert>
@@ -175,6 +176,31 @@ namespace spot
       {
       }
   };
+
+  /// \brief How many threads an algorithm may use.
+  ///
+  /// Algorithms that accept a parallel_policy may use up to
+  /// nthreads() threads.  Unless Spot was configured with
+  /// --enable-pthread, nthreads() is always 1, and everything runs
+  /// in the calling thread.
+  class SPOT_API parallel_policy
+  {
+    unsigned nthreads_;
+  public:
+    parallel_policy(unsigned nthreads = 1)
+      : nthreads_(nthreads ? nthreads : 1)
+    {
+    }
+
+    unsigned nthreads() const
+    {
+#ifdef SPOT_ENABLE_PTHREAD
+      return nthreads_;
+#else
+      return 1;
+#endif
+    }
+  };
 }
 
 // This is a workaround for the issue described in GNU GCC bug 89303.
@@ -0,0 +1,478 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2020 Laboratoire de Recherche et Développement
+// de l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <spot/misc/common.hh>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace spot
+{
+  namespace internal
+  {
+    template<class T>
+    struct identity_key
+    {
+      const T& operator()(const T& v) const noexcept
+      {
+        return v;
+      }
+    };
+
+    template<class P>
+    struct first_key
+    {
+      const typename P::first_type& operator()(const P& v) const noexcept
+      {
+        return v.first;
+      }
+    };
+
+    /// \brief The hash table behind open_hash_map and open_hash_set.
+    ///
+    /// Elements are stored, with their hash value, in a single array
+    /// whose size is a power of 2.  Collisions are resolved by
+    /// linear probing, using the Robin Hood heuristic: an element
+    /// being inserted takes the place of any element that is closer
+    /// to its home slot, so that all elements stay close to their
+    /// home slot, and a lookup can stop as soon as it meets an
+    /// element closer to its home slot than the searched key would
+    /// be.  Erased elements are removed by shifting the following
+    /// elements backward, so there are no tombstones.
+    template<class Key, class Value, class KeyOf, class Hash, class Equal,
+             bool Mutable>
+    class open_hash_table
+    {
+    public:
+      typedef Key key_type;
+      typedef Value value_type;
+      typedef Hash hasher;
+      typedef Equal key_equal;
+      typedef std::size_t size_type;
+
+    protected:
+      struct slot
+      {
+        // The hash value of the element, or 0 if the slot is empty.
+        std::size_t hash;
+        typename std::aligned_storage<sizeof(Value),
+                                      alignof(Value)>::type data;
+
+        Value& value() noexcept
+        {
+          return *reinterpret_cast<Value*>(&data);
+        }
+
+        const Value& value() const noexcept
+        {
+          return *reinterpret_cast<const Value*>(&data);
+        }
+      };
+
+      template<class V, class S>
+      class iter
+      {
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef V value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef V* pointer;
+        typedef V& reference;
+
+        iter() noexcept
+          : pos_(nullptr), end_(nullptr)
+        {
+        }
+
+        iter(S* pos, S* end) noexcept
+          : pos_(pos), end_(end)
+        {
+          skip();
+        }
+
+        template<class V2, class S2>
+        iter(const iter<V2, S2>& other) noexcept
+          : pos_(other.pos_), end_(other.end_)
+        {
+        }
+
+        V& operator*() const noexcept
+        {
+          return pos_->value();
+        }
+
+        V* operator->() const noexcept
+        {
+          return &pos_->value();
+        }
+
+        iter& operator++() noexcept
+        {
+          ++pos_;
+          skip();
+          return *this;
+        }
+
+        iter operator++(int) noexcept
+        {
+          iter res = *this;
+          ++*this;
+          return res;
+        }
+
+        bool operator==(const iter& other) const noexcept
+        {
+          return pos_ == other.pos_;
+        }
+
+        bool operator!=(const iter& other) const noexcept
+        {
+          return pos_ != other.pos_;
+        }
+
+      private:
+        void skip() noexcept
+        {
+          while (pos_ != end_ && !pos_->hash)
+            ++pos_;
+        }
+
+        S* pos_;
+        S* end_;
+
+        template<class, class> friend class iter;
+      };
+
+    public:
+      typedef iter<const Value, const slot> const_iterator;
+      typedef typename std::conditional<Mutable, iter<Value, slot>,
+                                        const_iterator>::type iterator;
+
+      open_hash_table() noexcept
+        : slots_(nullptr), mask_(0), size_(0), shift_(0)
+      {
+      }
+
+      open_hash_table(const open_hash_table&) = delete;
+      open_hash_table& operator=(const open_hash_table&) = delete;
+
+      ~open_hash_table()
+      {
+        clear();
+        ::operator delete(slots_);
+      }
+
+      iterator begin() noexcept
+      {
+        return iterator(slots_, slots_ + capacity());
+      }
+
+      iterator end() noexcept
+      {
+        slot* e = slots_ + capacity();
+        return iterator(e, e);
+      }
+
+      const_iterator begin() const noexcept
+      {
+        return const_iterator(slots_, slots_ + capacity());
+      }
+
+      const_iterator end() const noexcept
+      {
+        const slot* e = slots_ + capacity();
+        return const_iterator(e, e);
+      }
+
+      size_type size() const noexcept
+      {
+        return size_;
+      }
+
+      bool empty() const noexcept
+      {
+        return !size_;
+      }
+
+      /// The number of slots of the table.
+      size_type capacity() const noexcept
+      {
+        return slots_ ? mask_ + 1 : 0;
+      }
+
+      iterator find(const Key& k)
+      {
+        slot* s = lookup(k, hash_of(k));
+        return s ? iterator(s, slots_ + capacity()) : end();
+      }
+
+      const_iterator find(const Key& k) const
+      {
+        const slot* s = lookup(k, hash_of(k));
+        return s ? const_iterator(s, slots_ + capacity()) : end();
+      }
+
+      size_type count(const Key& k) const
+      {
+        return lookup(k, hash_of(k)) != nullptr;
+      }
+
+      /// \brief Insert an element constructed from \a args, unless an
+      /// element with the same key exists.
+      ///
+      /// Unlike with std::unordered_map, inserting an element may
+      /// move the other elements of the table: this invalidates all
+      /// iterators, pointers, and references to elements.
+      template<class... Args>
+      std::pair<iterator, bool> emplace(Args&&... args)
+      {
+        Value v(std::forward<Args>(args)...);
+        const Key& k = KeyOf()(v);
+        std::size_t h = hash_of(k);
+        if (slot* s = lookup(k, h))
+          return {iterator(s, slots_ + capacity()), false};
+        slot* s = insert_new(h, std::move(v));
+        return {iterator(s, slots_ + capacity()), true};
+      }
+
+      std::pair<iterator, bool> insert(const Value& v)
+      {
+        return emplace(v);
+      }
+
+      /// \brief Erase the element with key \a k, if any.
+      ///
+      /// Return the number of erased elements.  This invalidates
+      /// all iterators, pointers, and references to elements.
+      size_type erase(const Key& k)
+      {
+        slot* s = lookup(k, hash_of(k));
+        if (!s)
+          return 0;
+        erase_slot(s);
+        return 1;
+      }
+
+      void clear() noexcept
+      {
+        size_type cap = capacity();
+        for (size_type i = 0; i < cap; ++i)
+          if (slots_[i].hash)
+            {
+              slots_[i].value().~Value();
+              slots_[i].hash = 0;
+            }
+        size_ = 0;
+      }
+
+      /// Make room for \a n elements.
+      void reserve(size_type n)
+      {
+        size_type cap = capacity() ? capacity() : min_capacity;
+        while (n * 8 > cap * 7)
+          cap *= 2;
+        if (cap > capacity())
+          rehash(cap);
+      }
+
+    protected:
+      static constexpr size_type min_capacity = 8;
+
+      std::size_t hash_of(const Key& k) const
+      {
+        std::size_t h = hash_(k);
+        // 0 marks empty slots.
+        return h ? h : 1;
+      }
+
+      // The slot where an element with hash H should be stored.  The
+      // hash values of some keys (e.g., addresses) have poor low
+      // bits, so use Fibonacci hashing to select the slot from all
+      // the bits.
+      size_type home(std::size_t h) const noexcept
+      {
+        return (std::uint64_t(h) * 0x9E3779B97F4A7C15ULL) >> shift_;
+      }
+
+      // How far the element with hash H, stored at POS, is from its
+      // home slot.
+      size_type distance(std::size_t h, size_type pos) const noexcept
+      {
+        return (pos - home(h)) & mask_;
+      }
+
+      slot* lookup(const Key& k, std::size_t h) const
+      {
+        if (!size_)
+          return nullptr;
+        size_type pos = home(h);
+        for (size_type dist = 0;; ++dist)
+          {
+            slot* s = slots_ + pos;
+            if (!s->hash || distance(s->hash, pos) < dist)
+              return nullptr;
+            if (s->hash == h && eq_(KeyOf()(s->value()), k))
+              return s;
+            pos = (pos + 1) & mask_;
+          }
+      }
+
+      // Insert V, whose hash is H and whose key is not in the table.
+      slot* insert_new(std::size_t h, Value&& v)
+      {
+        if ((size_ + 1) * 8 > capacity() * 7)
+          rehash(capacity() ? 2 * capacity() : min_capacity);
+        ++size_;
+        return place(h, std::move(v));
+      }
+
+      slot* place(std::size_t h, Value&& v)
+      {
+        slot* res = nullptr;
+        size_type pos = home(h);
+        for (size_type dist = 0;; ++dist)
+          {
+            slot* s = slots_ + pos;
+            if (!s->hash)
+              {
+                s->hash = h;
+                new(&s->data) Value(std::move(v));
+                return res ? res : s;
+              }
+            size_type d = distance(s->hash, pos);
+            if (d < dist)
+              {
+                // Take the place of this element, which is closer
+                // to its home slot, and continue with it.
+                std::swap(h, s->hash);
+                std::swap(v, s->value());
+                if (!res)
+                  res = s;
+                dist = d;
+              }
+            pos = (pos + 1) & mask_;
+          }
+      }
+
+      void erase_slot(slot* s)
+      {
+        s->value().~Value();
+        size_type pos = s - slots_;
+        for (;;)
+          {
+            size_type next = (pos + 1) & mask_;
+            slot* n = slots_ + next;
+            if (!n->hash || distance(n->hash, next) == 0)
+              break;
+            slots_[pos].hash = n->hash;
+            new(&slots_[pos].data) Value(std::move(n->value()));
+            n->value().~Value();
+            pos = next;
+          }
+        slots_[pos].hash = 0;
+        --size_;
+      }
+
+      void rehash(size_type cap)
+      {
+        slot* old = slots_;
+        size_type old_cap = capacity();
+        slots_ = static_cast<slot*>(::operator new(cap * sizeof(slot)));
+        for (size_type i = 0; i < cap; ++i)
+          slots_[i].hash = 0;
+        mask_ = cap - 1;
+        shift_ = 64;
+        while (cap > 1)
+          {
+            cap /= 2;
+            --shift_;
+          }
+        for (size_type i = 0; i < old_cap; ++i)
+          if (old[i].hash)
+            {
+              place(old[i].hash, std::move(old[i].value()));
+              old[i].value().~Value();
+            }
+        ::operator delete(old);
+      }
+
+      slot* slots_;
+      size_type mask_;
+      size_type size_;
+      unsigned shift_;
+      Hash hash_;
+      Equal eq_;
+    };
+  }
+
+  /// \ingroup misc_tools
+  /// \brief A hash map with open addressing.
+  ///
+  /// This implements a subset of the interface of
+  /// std::unordered_map, but stores the elements inline in one
+  /// array instead of allocating one node per element, so it uses
+  /// less memory and is more cache-friendly.  The hash value of
+  /// each element is stored too, so that the (possibly costly)
+  /// equality predicate is only called on keys with the same hash.
+  ///
+  /// Unlike std::unordered_map, inserting or erasing an element
+  /// invalidates all iterators, pointers, and references to the
+  /// elements of the map.  Also, the elements are
+  /// <code>std::pair<Key, T></code> (the key is not const), but
+  /// their key should not be modified.
+  template<class Key, class T,
+           class Hash = std::hash<Key>, class Equal = std::equal_to<Key>>
+  class open_hash_map final:
+    public internal::open_hash_table<Key, std::pair<Key, T>,
+                                     internal::first_key<std::pair<Key, T>>,
+                                     Hash, Equal, true>
+  {
+  public:
+    typedef T mapped_type;
+
+    /// \brief Return the value associated to \a k, inserting a
+    /// default-constructed value if \a k is not in the map.
+    T& operator[](const Key& k)
+    {
+      std::size_t h = this->hash_of(k);
+      if (auto s = this->lookup(k, h))
+        return s->value().second;
+      return this->insert_new(h, std::pair<Key, T>(k, T()))->value().second;
+    }
+  };
+
+  /// \ingroup misc_tools
+  /// \brief A hash set with open addressing.
+  ///
+  /// See open_hash_map for the differences with
+  /// std::unordered_set.
+  template<class Key,
+           class Hash = std::hash<Key>, class Equal = std::equal_to<Key>>
+  class open_hash_set final:
+    public internal::open_hash_table<Key, Key, internal::identity_key<Key>,
+                                     Hash, Equal, false>
+  {
+  };
+}
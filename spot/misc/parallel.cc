@@ -0,0 +1,93 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2020 Laboratoire de Recherche et Développement de
+// l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "config.h"
+#include <spot/misc/parallel.hh>
+#ifdef ENABLE_PTHREAD
+#  include <algorithm>
+#  include <atomic>
+#  include <exception>
+#  include <mutex>
+#  include <system_error>
+#  include <thread>
+#  include <vector>
+#endif
+
+namespace spot
+{
+  void
+  parallel_for(parallel_policy ppolicy, unsigned n,
+               const std::function<void(unsigned i, unsigned worker)>& f)
+  {
+#ifdef ENABLE_PTHREAD
+    unsigned nthreads = std::min(ppolicy.nthreads(), n);
+    if (nthreads > 1)
+      {
+        std::atomic<unsigned> next(0);
+        std::atomic<bool> failed(false);
+        std::exception_ptr error = nullptr;
+        std::mutex error_mutex;
+        auto work = [&](unsigned worker)
+          {
+            while (!failed.load(std::memory_order_relaxed))
+              {
+                unsigned i = next.fetch_add(1, std::memory_order_relaxed);
+                if (i >= n)
+                  return;
+                try
+                  {
+                    f(i, worker);
+                  }
+                catch (...)
+                  {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error)
+                      error = std::current_exception();
+                    failed = true;
+                  }
+              }
+          };
+        std::vector<std::thread> threads;
+        threads.reserve(nthreads - 1);
+        for (unsigned w = 1; w < nthreads; ++w)
+          try
+            {
+              threads.emplace_back(work, w);
+            }
+          catch (const std::system_error&)
+            {
+              // Could not start more threads.  The work is
+              // distributed dynamically, so those already started
+              // will do the job.
+              break;
+            }
+        work(0);
+        for (auto& t: threads)
+          t.join();
+        if (error)
+          std::rethrow_exception(error);
+        return;
+      }
+#else
+    (void) ppolicy;
+#endif
+    for (unsigned i = 0; i < n; ++i)
+      f(i, 0);
+  }
+}
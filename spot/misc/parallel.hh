@@ -0,0 +1,44 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2020 Laboratoire de Recherche et Développement de
+// l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <spot/misc/common.hh>
+#include <functional>
+
+namespace spot
+{
+  /// \brief Call \a f on all integers of [0,n) using several threads.
+  ///
+  /// \a f receives the integer to process, and the number of the
+  /// worker that processes it, between 0 and ppolicy.nthreads()-1.
+  /// Worker 0 is the calling thread.  The integers are distributed
+  /// dynamically to the workers, so they are not processed in any
+  /// particular order, and this function returns only once they
+  /// have all been processed.
+  ///
+  /// If \a f throws an exception, no new integer is processed, and
+  /// the first exception is rethrown once all threads have stopped.
+  ///
+  /// With a single thread, this is just a loop over [0,n) in
+  /// increasing order.
+  SPOT_API void
+  parallel_for(parallel_policy ppolicy, unsigned n,
+               const std::function<void(unsigned i, unsigned worker)>& f);
+}
@@ -26,7 +26,13 @@
 
 namespace spot
 {
-  static std::mt19937 gen;
+  static random_generator gen;
+
+  random_generator&
+  default_random_generator()
+  {
+    return gen;
+  }
 
   void
   srand(unsigned int seed)
@@ -37,23 +43,29 @@ namespace spot
   double
   drand()
   {
-    return  gen() / (1.0 + gen.max());
+    return gen.drand();
   }
 
   int
   mrand(int max)
   {
-    return static_cast<int>(max * drand());
+    return gen.mrand(max);
   }
 
   int
   rrand(int min, int max)
   {
-    return min + static_cast<int>((max - min + 1) * drand());
+    return gen.rrand(min, max);
   }
 
   double
   nrand()
+  {
+    return gen.nrand();
+  }
+
+  double
+  random_generator::nrand()
   {
     const double r = drand();
 
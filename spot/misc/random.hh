@@ -25,6 +25,7 @@
 #include <spot/misc/common.hh>
 #include <cassert>
 #include <cmath>
+#include <random>
 #include <vector>
 
 namespace spot
@@ -35,6 +36,65 @@ namespace spot
   /// \ingroup random
   /// @{
 
+  /// \brief A pseudo-random number generator.
+  ///
+  /// The functions srand(), rrand(), mrand(), drand(), and nrand()
+  /// all share a global generator.  Instances of this class have
+  /// their own state, so that several sequences of random numbers
+  /// can be drawn independently (for instance, one per generated
+  /// object, or one per thread).  An instance used with some seed
+  /// produces the same numbers as the global functions after a call
+  /// to srand() with the same seed.
+  class SPOT_API random_generator
+  {
+  public:
+    explicit random_generator(unsigned int seed
+                              = std::mt19937::default_seed)
+      : gen_(seed)
+    {
+    }
+
+    /// \brief Reset the seed of the generator.
+    void seed(unsigned int seed)
+    {
+      gen_.seed(seed);
+    }
+
+    /// \brief Compute a pseudo-random double value
+    /// between 0.0 and 1.0 (1.0 excluded).
+    double drand()
+    {
+      return gen_() / (1.0 + gen_.max());
+    }
+
+    /// \brief Compute a pseudo-random integer value between 0 and
+    /// \a max-1 included.
+    int mrand(int max)
+    {
+      return static_cast<int>(max * drand());
+    }
+
+    /// \brief Compute a pseudo-random integer value between \a min
+    /// and \a max included.
+    int rrand(int min, int max)
+    {
+      return min + static_cast<int>((max - min + 1) * drand());
+    }
+
+    /// \brief Compute a pseudo-random double value
+    /// following a standard normal distribution.  (Odeh & Evans)
+    ///
+    /// \see spot::nrand()
+    double nrand();
+
+  private:
+    std::mt19937 gen_;
+  };
+
+  /// \brief Return the generator used by srand(), rrand(), mrand(),
+  /// drand(), and nrand().
+  SPOT_API random_generator& default_random_generator();
+
   /// \brief Reset the seed of the pseudo-random number generator.
   ///
   /// \see drand, mrand, rrand
@@ -77,6 +137,9 @@ namespace spot
   /// Usually approximating a binomial distribution using a normal
   /// distribution and is accurate only if <code>n*p</code> and
   /// <code>n*(1-p)</code> are greater than 5.
+  ///
+  /// rand() can also be given a random_generator, in which case its
+  /// random_generator::nrand() method is used instead of \a gen.
   template<double (*gen)()>
   class barand
   {
@@ -88,10 +151,23 @@ namespace spot
 
     int
     rand() const
+    {
+      return draw_([]() { return gen(); });
+    }
+
+    int
+    rand(random_generator& g) const
+    {
+      return draw_([&g]() { return g.nrand(); });
+    }
+  protected:
+    template<class normal>
+    int
+    draw_(normal n) const
     {
       for (;;)
         {
-          int x = round(gen() * s_ + m_);
+          int x = round(n() * s_ + m_);
           if (x < 0)
             continue;
           if (x <= n_)
@@ -100,7 +176,7 @@ namespace spot
       SPOT_UNREACHABLE();
       return 0;
     }
-  protected:
+
     const int n_;
     const double m_;
     const double s_;
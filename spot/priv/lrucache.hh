@@ -0,0 +1,168 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2020 Laboratoire de Recherche et Développement de
+// l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace spot
+{
+  /// \brief Memory budget shared by several lru_cache instances.
+  ///
+  /// \a used is the estimated number of bytes used by all the caches
+  /// attached to this budget.  A \a limit of 0 means unbounded.
+  struct cache_budget
+  {
+    std::size_t limit = 0;
+    std::size_t used = 0;
+
+    bool exceeded() const
+    {
+      return limit && used > limit;
+    }
+  };
+
+  /// \brief A hash map that evicts its least recently used entries
+  /// when the budget it is attached to is exceeded.
+  ///
+  /// Entries are kept in a list ordered by last use, and indexed
+  /// by a hash table.  Inserting an entry that makes the budget
+  /// exceed its limit causes the least recently used entries of \e
+  /// this cache to be evicted.  The memory accounting is an estimate
+  /// of the size of the nodes of the list and of the hash table; it
+  /// does not include any memory indirectly held by the keys or
+  /// values.
+  template<class Key, class Value,
+           class Hash = std::hash<Key>,
+           class Equal = std::equal_to<Key>>
+  class lru_cache
+  {
+    typedef std::list<std::pair<Key, Value>> list_t;
+    typedef std::unordered_map<Key, typename list_t::iterator,
+                               Hash, Equal> index_t;
+    list_t entries_;            // Most recently used first.
+    index_t index_;
+    cache_budget* budget_;
+    std::size_t hits_ = 0;
+    std::size_t misses_ = 0;
+    std::size_t evictions_ = 0;
+
+  public:
+    /// Estimated number of bytes used by each entry: a list node with
+    /// two pointers, a hash-table node with a next pointer and a
+    /// cached hash value, and one bucket.
+    static constexpr std::size_t entry_bytes =
+      sizeof(typename list_t::value_type) + 2 * sizeof(void*)
+      + sizeof(typename index_t::value_type) + 2 * sizeof(void*)
+      + sizeof(std::size_t);
+
+    lru_cache(cache_budget* budget)
+      : budget_(budget)
+    {
+    }
+
+    ~lru_cache()
+    {
+      clear();
+    }
+
+    lru_cache(const lru_cache&) = delete;
+    lru_cache& operator=(const lru_cache&) = delete;
+
+    /// \brief Look up \a k.
+    ///
+    /// Return a pointer to the associated value, or nullptr if \a k
+    /// is not in the cache.  The pointer is only valid until the
+    /// next insertion.
+    const Value* find(const Key& k)
+    {
+      auto i = index_.find(k);
+      if (i == index_.end())
+        {
+          ++misses_;
+          return nullptr;
+        }
+      ++hits_;
+      entries_.splice(entries_.begin(), entries_, i->second);
+      return &i->second->second;
+    }
+
+    /// \brief Associate \a v to \a k.
+    ///
+    /// This may evict older entries if the budget is exceeded.
+    void insert(const Key& k, const Value& v)
+    {
+      auto p = index_.emplace(k, entries_.end());
+      if (!p.second)
+        {
+          auto it = p.first->second;
+          it->second = v;
+          entries_.splice(entries_.begin(), entries_, it);
+          return;
+        }
+      entries_.emplace_front(k, v);
+      p.first->second = entries_.begin();
+      budget_->used += entry_bytes;
+      // Never evict the entry we have just inserted.
+      while (budget_->exceeded() && entries_.size() > 1)
+        {
+          index_.erase(entries_.back().first);
+          entries_.pop_back();
+          budget_->used -= entry_bytes;
+          ++evictions_;
+        }
+    }
+
+    void clear()
+    {
+      budget_->used -= bytes();
+      index_.clear();
+      entries_.clear();
+    }
+
+    std::size_t size() const
+    {
+      return index_.size();
+    }
+
+    std::size_t bytes() const
+    {
+      return size() * entry_bytes;
+    }
+
+    std::size_t hits() const
+    {
+      return hits_;
+    }
+
+    std::size_t misses() const
+    {
+      return misses_;
+    }
+
+    std::size_t evictions() const
+    {
+      return evictions_;
+    }
+  };
+}
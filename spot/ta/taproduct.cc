@@ -246,6 +246,7 @@ namespace spot
     assert(dict_ == kripke_structure->get_dict());
     dict_->register_all_variables_of(ta_, this);
     dict_->register_all_variables_of(kripke_, this);
+    acc() = ta_->acc();
   }
 
   ta_product::~ta_product()
@@ -359,7 +360,7 @@ namespace spot
   {
     const state_ta_product* stp = down_cast<const state_ta_product*> (s);
     ta_succ_iterator* ta_succ_iter = get_ta()->succ_iter(stp->get_ta_state());
-    bool is_hole_state = ta_succ_iter->done();
+    bool is_hole_state = !ta_succ_iter->first();
     delete ta_succ_iter;
     return is_hole_state;
   }
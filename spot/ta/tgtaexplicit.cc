@@ -31,6 +31,7 @@ namespace spot
     tgta(tgba->get_dict()),
     ta_(make_ta_explicit(tgba, n_acc, artificial_initial_state))
   {
+    set_acceptance(ta_->acc());
   }
 
   state*
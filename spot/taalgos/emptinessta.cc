@@ -410,7 +410,7 @@ namespace spot
                 continue;
               }
 
-            sscc.push(num);
+            sscc.push(++num);
             sscc.top().is_accepting = t->is_livelock_accepting_state(init);
             ta_succ_iterator_product* iter = t->succ_iter(init);
             iter->first();
@@ -27,12 +27,16 @@
 #  define trace while (0) std::cerr
 #endif
 
+#include <algorithm>
+#include <map>
 #include <set>
 #include <list>
 #include <sstream>
+#include <tuple>
+#include <vector>
 #include <spot/taalgos/minimize.hh>
-#include <spot/misc/hash.hh>
 #include <spot/misc/bddlt.hh>
+#include <spot/misc/hash.hh>
 #include <spot/ta/tgtaexplicit.hh>
 #include <spot/taalgos/statessetbuilder.hh>
 #include <spot/twa/twagraph.hh>
@@ -182,321 +186,204 @@ namespace spot
          }
      }
 
+    // The signature of a state: for each class of destination
+    // states and each set of acceptance marks, the disjunction of the
+    // conditions of the transitions leading to that class with those
+    // marks.  Two states of the same class are equivalent if they
+    // have the same signature.  The conditions are stored as BDDs
+    // (not as BDD ids) so that they stay alive as long as the
+    // signature.
+    typedef std::vector<std::tuple<unsigned, acc_cond::mark_t, bdd>>
+      signature_t;
+
+    struct signature_less_than
+    {
+      bool
+      operator()(const signature_t& left, const signature_t& right) const
+      {
+        return std::lexicographical_compare
+          (left.begin(), left.end(), right.begin(), right.end(),
+           [](const signature_t::value_type& l,
+              const signature_t::value_type& r)
+           {
+             if (std::get<0>(l) != std::get<0>(r))
+               return std::get<0>(l) < std::get<0>(r);
+             if (std::get<1>(l) != std::get<1>(r))
+               return std::get<1>(l) < std::get<1>(r);
+             return bdd_less_than()(std::get<2>(l), std::get<2>(r));
+           });
+      }
+    };
+
+    // Compute the coarsest partition of the states of TA_ that
+    // separates initial, livelock-accepting and Buchi-accepting
+    // states, and such that equivalent states have the same
+    // signature.
+    //
+    // States are numbered, and classes are only identified by
+    // integers.  When a class is split, the largest part keeps the
+    // number of the class, so only the predecessors of the other
+    // parts can see their signature change: only their classes need
+    // to be examined again.
     static partition_t
     build_partition(const const_ta_ptr& ta_)
     {
-      unsigned num_sets = ta_->acc().num_sets();
-      std::map<acc_cond::mark_t, bdd> m2b;
-      int acc_vars = ta_->get_dict()->register_anonymous_variables(num_sets,
-                                                                   &m2b);
-      auto mark_to_bdd = [&](acc_cond::mark_t m) -> bdd
-        {
-          auto i = m2b.find(m);
-          if (i != m2b.end())
-            return i->second;
-
-          bdd res = bddtrue;
-          for (unsigned n = 0; n < num_sets; ++n)
-            if (m.has(n))
-              res &= bdd_ithvar(acc_vars + n);
-            else
-              res &= bdd_nithvar(acc_vars + n);
-          m2b.emplace_hint(i, m, res);
-          return res;
-        };
-
-      partition_t cur_run;
-      partition_t next_run;
-
-      // The list of equivalent states.
-      partition_t done;
-
       std::set<const state*> states_set = get_states_set(ta_);
-
-      hash_set* I = new hash_set;
-
-      // livelock acceptance states
-      hash_set* G = new hash_set;
-
-      // Buchi acceptance states
-      hash_set* F = new hash_set;
-
-      // Buchi and livelock acceptance states
-      hash_set* G_F = new hash_set;
-
-      // the other states (non initial and not in G, F and G_F)
-      hash_set* S = new hash_set;
-
-      std::set<const state*>::iterator it;
-
-      auto artificial_initial_state = ta_->get_artificial_initial_state();
-
-      for (it = states_set.begin(); it != states_set.end(); ++it)
-        {
-          const state* s = *it;
-          if (s == artificial_initial_state)
-            I->insert(s);
-          else if (!artificial_initial_state && ta_->is_initial_state(s))
-            I->insert(s);
-          else if (ta_->is_livelock_accepting_state(s)
-                   && ta_->is_accepting_state(s))
-            G_F->insert(s);
-          else if (ta_->is_accepting_state(s))
-            F->insert(s);
-          else if (ta_->is_livelock_accepting_state(s))
-            G->insert(s);
-          else
-            S->insert(s);
-        }
-
-      hash_map state_set_map;
-
-      // Size of ta_
-      unsigned size = states_set.size() + 6;
-      // Use bdd variables to number sets.  set_num is the first variable
-      // available.
-      unsigned set_num =
-        ta_->get_dict()->register_anonymous_variables(size, &m2b);
-
-      std::set<int> free_var;
-      for (unsigned i = set_num; i < set_num + size; ++i)
-        free_var.insert(i);
-      std::map<int, int> used_var;
-
-      for (hash_set::const_iterator i = I->begin(); i != I->end(); ++i)
-        {
-          hash_set* cI = new hash_set;
-          cI->insert(*i);
-          done.emplace_back(cI);
-
-          used_var[set_num] = 1;
-          free_var.erase(set_num);
-          state_set_map[*i] = set_num;
-          ++set_num;
-
-        }
-      delete I;
-
-      if (!G->empty())
-        {
-          unsigned s = G->size();
-          unsigned num = set_num;
-          ++set_num;
-          used_var[num] = s;
-          free_var.erase(num);
-          if (s > 1)
-            cur_run.emplace_back(G);
-          else
-            done.emplace_back(G);
-          for (hash_set::const_iterator i = G->begin(); i != G->end(); ++i)
-            state_set_map[*i] = num;
-
-        }
-      else
-        {
-          delete G;
-        }
-
-      if (!F->empty())
+      std::vector<const state*> state_of(states_set.begin(),
+                                         states_set.end());
+      unsigned n = state_of.size();
+      hash_map state_num;
+      for (unsigned i = 0; i < n; ++i)
+        state_num[state_of[i]] = i;
+
+      struct transition
+      {
+        unsigned dst;
+        acc_cond::mark_t acc;
+        bdd cond;
+      };
+      std::vector<std::vector<transition>> succ(n);
+      std::vector<std::vector<unsigned>> pred(n);
+      for (unsigned i = 0; i < n; ++i)
         {
-          unsigned s = F->size();
-          unsigned num = set_num;
-          ++set_num;
-          used_var[num] = s;
-          free_var.erase(num);
-          if (s > 1)
-            cur_run.emplace_back(F);
-          else
-            done.emplace_back(F);
-          for (hash_set::const_iterator i = F->begin(); i != F->end(); ++i)
-            state_set_map[*i] = num;
-        }
-      else
-        {
-          delete F;
+          ta_succ_iterator* si = ta_->succ_iter(state_of[i]);
+          for (si->first(); !si->done(); si->next())
+            {
+              hash_map::const_iterator d = state_num.find(si->dst());
+              assert(d != state_num.end());
+              succ[i].push_back({d->second, si->acc(), si->cond()});
+              pred[d->second].push_back(i);
+            }
+          delete si;
         }
 
-      if (!G_F->empty())
-        {
-          unsigned s = G_F->size();
-          unsigned num = set_num;
-          ++set_num;
-          used_var[num] = s;
-          free_var.erase(num);
-          if (s > 1)
-            cur_run.emplace_back(G_F);
-          else
-            done.emplace_back(G_F);
-          for (hash_set::const_iterator i = G_F->begin(); i != G_F->end(); ++i)
-            state_set_map[*i] = num;
-        }
-      else
+      // The initial partition.  Each initial state is alone in its
+      // class.
+      std::vector<std::vector<unsigned>> classes;
+      std::vector<unsigned> class_of(n);
+      {
+        // livelock acceptance states
+        std::vector<unsigned> G;
+        // Buchi acceptance states
+        std::vector<unsigned> F;
+        // Buchi and livelock acceptance states
+        std::vector<unsigned> G_F;
+        // the other states (non initial and not in G, F and G_F)
+        std::vector<unsigned> S;
+
+        auto artificial_initial_state = ta_->get_artificial_initial_state();
+        for (unsigned i = 0; i < n; ++i)
+          {
+            const state* s = state_of[i];
+            if (s == artificial_initial_state
+                || (!artificial_initial_state && ta_->is_initial_state(s)))
+              classes.emplace_back(1, i);
+            else if (ta_->is_livelock_accepting_state(s)
+                     && ta_->is_accepting_state(s))
+              G_F.push_back(i);
+            else if (ta_->is_accepting_state(s))
+              F.push_back(i);
+            else if (ta_->is_livelock_accepting_state(s))
+              G.push_back(i);
+            else
+              S.push_back(i);
+          }
+        for (auto* set: {&G, &F, &G_F, &S})
+          if (!set->empty())
+            classes.emplace_back(std::move(*set));
+        for (unsigned c = 0; c < classes.size(); ++c)
+          for (unsigned i: classes[c])
+            class_of[i] = c;
+      }
+
+      std::vector<unsigned> todo;
+      std::vector<bool> in_todo(classes.size(), false);
+      auto schedule = [&](unsigned c)
         {
-          delete G_F;
-        }
+          if (in_todo[c] || classes[c].size() < 2)
+            return;
+          in_todo[c] = true;
+          todo.push_back(c);
+        };
+      for (unsigned c = 0; c < classes.size(); ++c)
+        schedule(c);
 
-      if (!S->empty())
+      typedef std::pair<unsigned, acc_cond::mark_t> sig_key;
+      std::vector<std::pair<sig_key, bdd>> sig;
+      while (!todo.empty())
         {
-          unsigned s = S->size();
-          unsigned num = set_num;
-          ++set_num;
-          used_var[num] = s;
-          free_var.erase(num);
-          if (s > 1)
-            cur_run.emplace_back(S);
-          else
-            done.emplace_back(S);
-          for (hash_set::const_iterator i = S->begin(); i != S->end(); ++i)
-            state_set_map[*i] = num;
-        }
-      else
-        {
-          delete S;
-        }
-
-
-      // A bdd_states_map is a list of formulae (in a BDD form)
-      // associated with a destination set of states.
-      typedef std::map<bdd, hash_set*, bdd_less_than> bdd_states_map;
+          unsigned c = todo.back();
+          todo.pop_back();
+          in_todo[c] = false;
 
-      bool did_split = true;
-      unsigned num = set_num;
-      ++set_num;
-      used_var[num] = 1;
-      free_var.erase(num);
-      bdd bdd_false_acceptance_condition = bdd_ithvar(num);
-
-      while (did_split)
-        {
-          did_split = false;
-          while (!cur_run.empty())
+          std::map<signature_t, std::vector<unsigned>,
+                   signature_less_than> parts;
+          for (unsigned i: classes[c])
             {
-              // Get a set to process.
-              hash_set* cur = cur_run.front();
-              cur_run.pop_front();
-
-              trace
-                << "processing " << format_hash_set(cur, ta_) << std::endl;
-
-              hash_set::iterator hi;
-              bdd_states_map bdd_map;
-              for (hi = cur->begin(); hi != cur->end(); ++hi)
-                {
-                  const state* src = *hi;
-                  bdd f = bddfalse;
-                  ta_succ_iterator* si = ta_->succ_iter(src);
-                  trace << "+src: " << src << std::endl;
-                  for (si->first(); !si->done(); si->next())
-                    {
-                      const state* dst = si->dst();
-                      hash_map::const_iterator i = state_set_map.find(dst);
-
-                      assert(i != state_set_map.end());
-                      auto curacc =
-                        mark_to_bdd(si->acc());
-                      f |= (bdd_ithvar(i->second)
-                            & si->cond() & curacc);
-                      trace
-                        << "+f: " << bdd_format_accset(ta_->get_dict(), f)
-                        << "\n      -bdd_ithvar(i->second): "
-                        << bdd_format_accset(ta_->get_dict(),
-                                             bdd_ithvar(i->second))
-                        << "\n      -si->cond(): "
-                        << bdd_format_accset(ta_->get_dict(),
-                                             si->cond())
-                        << "\n      -current_acceptance_conditions: "
-                        << si->acc()
-                      << std::endl;
-                    }
-                  delete si;
-
-                  // Have we already seen this formula ?
-                  bdd_states_map::iterator bsi = bdd_map.find(f);
-                  if (bsi == bdd_map.end())
-                    {
-                      // No, create a new set.
-                      hash_set* new_set = new hash_set;
-                      new_set->insert(src);
-                      bdd_map[f] = new_set;
-                    }
-                  else
-                    {
-                      // Yes, add the current state to the set.
-                      bsi->second->insert(src);
-                    }
-                }
-
-              bdd_states_map::iterator bsi = bdd_map.begin();
-              if (bdd_map.size() == 1)
-                {
-                  // The set was not split.
-                  trace
-                    << "set " << format_hash_set(bsi->second, ta_)
-                    << " was not split" << std::endl;
-                  next_run.emplace_back(bsi->second);
-                }
-              else
-                {
-                  did_split = true;
-                  for (; bsi != bdd_map.end(); ++bsi)
-                    {
-                      hash_set* set = bsi->second;
-                      // Free the number associated to these states.
-                      unsigned num = state_set_map[*set->begin()];
-                      assert(used_var.find(num) != used_var.end());
-                      unsigned left = (used_var[num] -= set->size());
-                      // Make sure LEFT does not become negative
-                      // (hence bigger than SIZE when read as unsigned)
-                      assert(left < size);
-                      if (left == 0)
-                        {
-                          used_var.erase(num);
-                          free_var.insert(num);
-                        }
-                      // Pick a free number
-                      assert(!free_var.empty());
-                      num = *free_var.begin();
-                      free_var.erase(free_var.begin());
-                      used_var[num] = set->size();
-                      for (hash_set::iterator hit = set->begin();
-                           hit != set->end(); ++hit)
-                        state_set_map[*hit] = num;
-                      // Trivial sets can't be splitted any further.
-                      if (set->size() == 1)
+              sig.clear();
+              for (auto& t: succ[i])
+                sig.push_back({{class_of[t.dst], t.acc}, t.cond});
+              std::sort(sig.begin(), sig.end(),
+                        [](const std::pair<sig_key, bdd>& l,
+                           const std::pair<sig_key, bdd>& r)
                         {
-                          trace
-                            << "set " << format_hash_set(set, ta_)
-                            << " is minimal" << std::endl;
-                          done.emplace_back(set);
-                        }
-                      else
-                        {
-                          trace
-                            << "set " << format_hash_set(set, ta_)
-                            << " should be processed further" << std::endl;
-                          next_run.emplace_back(set);
-                        }
-                    }
+                          return l.first < r.first;
+                        });
+              signature_t key;
+              for (unsigned j = 0; j < sig.size(); ++j)
+                {
+                  bdd cond = sig[j].second;
+                  while (j + 1 < sig.size()
+                         && sig[j + 1].first == sig[j].first)
+                    cond |= sig[++j].second;
+                  key.emplace_back(sig[j].first.first, sig[j].first.second,
+                                   cond);
                 }
-              delete cur;
+              parts[key].push_back(i);
             }
-          if (did_split)
-            trace
-              << "splitting did occur during this pass." << std::endl;
-
-          std::swap(cur_run, next_run);
+          if (parts.size() == 1)
+            continue;
+
+          trace << "class " << c << " was split in " << parts.size()
+                << " parts" << std::endl;
+
+          // The largest part keeps number C.
+          auto largest = parts.begin();
+          for (auto i = parts.begin(); i != parts.end(); ++i)
+            if (i->second.size() > largest->second.size())
+              largest = i;
+          unsigned first_new = classes.size();
+          for (auto i = parts.begin(); i != parts.end(); ++i)
+            {
+              if (i == largest)
+                continue;
+              unsigned nc = classes.size();
+              for (unsigned s: i->second)
+                class_of[s] = nc;
+              classes.emplace_back(std::move(i->second));
+              in_todo.push_back(false);
+            }
+          classes[c] = std::move(largest->second);
+          for (unsigned nc = first_new; nc < classes.size(); ++nc)
+            for (unsigned s: classes[nc])
+              for (unsigned p: pred[s])
+                schedule(class_of[p]);
         }
 
-      done.splice(done.end(), cur_run);
+      partition_t done;
+      for (auto& c: classes)
+        {
+          hash_set* set = new hash_set;
+          for (unsigned i: c)
+            set->insert(state_of[i]);
+          done.emplace_back(set);
+        }
 
-#ifdef TRACE
       trace << "Final partition: ";
       for (partition_t::const_iterator i = done.begin(); i != done.end(); ++i)
         trace << format_hash_set(*i, ta_) << ' ';
       trace << std::endl;
-#endif
 
-      ta_->get_dict()->unregister_all_my_variables(&m2b);
       return done;
     }
   }
@@ -31,6 +31,7 @@
 #include <cassert>
 #include <spot/twa/bddprint.hh>
 #include <stack>
+#include <vector>
 #include <spot/taalgos/tgba2ta.hh>
 #include <spot/taalgos/statessetbuilder.hh>
 #include <spot/ta/tgtaexplicit.hh>
@@ -389,6 +390,20 @@ namespace spot
       std::stack<state_ta_explicit*> todo;
       const_twa_ptr tgba_ = ta->get_tgba();
 
+      // All the valuations of the atomic propositions, i.e., the
+      // possible conditions of the states of TA.
+      std::vector<bdd> valuations;
+      {
+        bdd all_props = bddtrue;
+        bdd v;
+        while ((v = bdd_satoneset(all_props, atomic_propositions_set_,
+                                  bddtrue)) != bddfalse)
+          {
+            all_props -= v;
+            valuations.push_back(v);
+          }
+      }
+
       // build Initial states set:
       auto tgba_init_state = tgba_->get_init_state();
 
@@ -438,20 +453,15 @@ namespace spot
                twa_succ_it->next())
             {
               const state* tgba_state = twa_succ_it->dst();
-              bdd tgba_condition = twa_succ_it->cond();
               acc_cond::mark_t tgba_acceptance_conditions =
                 twa_succ_it->acc();
-              bdd satone_tgba_condition;
-              while ((satone_tgba_condition =
-                      bdd_satoneset(tgba_condition,
-                                    atomic_propositions_set_, bddtrue))
-                     != bddfalse)
-                {
-                  tgba_condition -= satone_tgba_condition;
-
-                  bdd all_props = bddtrue;
-                  bdd dest_condition;
 
+              // The valuation of SOURCE is a minterm of the atomic
+              // propositions: this transition can be taken from
+              // SOURCE iff its condition intersects it.
+              if ((source->get_tgba_condition() & twa_succ_it->cond())
+                  != bddfalse)
+                {
                   bool is_acc = false;
                   if (degeneralized)
                   {
@@ -462,34 +472,29 @@ namespace spot
                     delete it;
                   }
 
-                  if (satone_tgba_condition == source->get_tgba_condition())
-                    while ((dest_condition =
-                            bdd_satoneset(all_props,
-                                          atomic_propositions_set_, bddtrue))
-                           != bddfalse)
-                      {
-                        all_props -= dest_condition;
-                        state_ta_explicit* new_dest =
-                          new state_ta_explicit(tgba_state->clone(),
-                                                dest_condition, false, is_acc);
-                        state_ta_explicit* dest = ta->add_state(new_dest);
-
-                        if (dest != new_dest)
-                          {
-                            // the state dest already exists in the automaton
-                            new_dest->get_tgba_state()->destroy();
-                            delete new_dest;
-                          }
-                        else
-                          {
-                            todo.push(dest);
-                          }
-
-                        bdd cs = bdd_setxor(source->get_tgba_condition(),
-                                            dest->get_tgba_condition());
-                        ta->create_transition(source, cs,
-                                              tgba_acceptance_conditions, dest);
-                      }
+                  for (bdd dest_condition: valuations)
+                    {
+                      state_ta_explicit* new_dest =
+                        new state_ta_explicit(tgba_state->clone(),
+                                              dest_condition, false, is_acc);
+                      state_ta_explicit* dest = ta->add_state(new_dest);
+
+                      if (dest != new_dest)
+                        {
+                          // the state dest already exists in the automaton
+                          new_dest->get_tgba_state()->destroy();
+                          delete new_dest;
+                        }
+                      else
+                        {
+                          todo.push(dest);
+                        }
+
+                      bdd cs = bdd_setxor(source->get_tgba_condition(),
+                                          dest->get_tgba_condition());
+                      ta->create_transition(source, cs,
+                                            tgba_acceptance_conditions, dest);
+                    }
                 }
               tgba_state->destroy();
             }
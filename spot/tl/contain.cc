@@ -47,6 +47,7 @@ namespace spot
   language_containment_checker::clear()
   {
     translated_.clear();
+    bytes_ = 0;
   }
 
   bool
@@ -59,6 +60,9 @@ namespace spot
     bool res = product(l->translation, g->translation)->is_empty();
     l->incompatible[g] = res;
     g->incompatible[l] = res;
+    // Roughly the size of the two nodes of the std::map.
+    bytes_ += 2 * (sizeof(record_::incomp_map::value_type)
+                   + 4 * sizeof(void*));
     return res;
   }
 
@@ -126,6 +130,9 @@ namespace spot
                             branching_postponement_, fair_loop_approx_);
     record_& r = translated_[f];
     r.translation = e;
+    bytes_ += sizeof(trans_map::value_type) + sizeof(twa_graph)
+      + e->num_states() * sizeof(twa_graph::graph_t::state_storage_t)
+      + e->num_edges() * sizeof(twa_graph::edge_storage_t);
     return &r;
   }
 }
@@ -63,6 +63,15 @@ namespace spot
     /// Check whether L(l) = L(g).
     bool equal(formula l, formula g);
 
+    /// \brief Estimated number of bytes used by the cache.
+    ///
+    /// This accounts for the translated automata and the results of
+    /// the containment checks, not for the formulas themselves.
+    size_t memory_used() const
+    {
+      return bytes_;
+    }
+
   protected:
     bool incompatible_(record_* l, record_* g);
 
@@ -76,5 +85,6 @@ namespace spot
     bool fair_loop_approx_;
     /* Translation Maps */
     trans_map translated_;
+    size_t bytes_ = 0;
   };
 }
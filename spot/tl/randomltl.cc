@@ -25,8 +25,13 @@
 #include <algorithm>
 #include <spot/tl/randomltl.hh>
 #include <spot/misc/random.hh>
+#include <spot/misc/bloom.hh>
+#include <spot/misc/hashfunc.hh>
+#include <spot/tl/print.hh>
 #include <iostream>
 #include <cstring>
+#include <limits>
+#include <stdexcept>
 #include <spot/misc/optionmap.hh>
 #include <spot/tl/defaultenv.hh>
 #include <sstream>
@@ -403,13 +408,46 @@ namespace spot
     update_sums();
   }
 
+  namespace
+  {
+    // The size in megabytes of the Bloom filter, or 0.  The filter
+    // has 8 << 20 bits per megabyte, and this size must fit in a
+    // size_t.
+    size_t
+    unique_filter_mb(const option_map& opts)
+    {
+      int filter_mb = opts.get("unique_filter", 0);
+      if (filter_mb <= 0)
+        return 0;
+      if (size_t(filter_mb) > (std::numeric_limits<size_t>::max() >> 23))
+        throw std::invalid_argument("unique_filter is too large");
+      return filter_mb;
+    }
+
+    // The caches of the simplifier (including the automata built for
+    // containment checks) are seldom useful across random formulas,
+    // and would grow without bound.  Unless told otherwise, bound
+    // them to the size of the Bloom filter when one is used.
+    tl_simplifier_options
+    simplifier_options(int level, const option_map& opts)
+    {
+      tl_simplifier_options options{level};
+      options.cache_size_limit = unique_filter_mb(opts) << 20;
+      constexpr int unset = std::numeric_limits<int>::min();
+      int cache_kb = opts.get("simpl_cache_size", unset);
+      if (cache_kb != unset)
+        options.cache_size_limit = cache_kb > 0 ? size_t(cache_kb) << 10 : 0;
+      return options;
+    }
+  }
+
   randltlgenerator::randltlgenerator(atomic_prop_set aprops,
                                      const option_map& opts,
                                      char* opt_pL,
                                      char* opt_pS,
                                      char* opt_pB)
     : opt_simpl_level_(opts.get("simplification_level", 3)),
-      simpl_(tl_simplifier_options{opt_simpl_level_})
+      simpl_(simplifier_options(opt_simpl_level_, opts))
   {
     aprops_ = aprops;
     output_ = opts.get("output", randltlgenerator::LTL);
@@ -472,6 +510,10 @@ namespace spot
       throw std::invalid_argument("failed to parse Boolean priorities near "
                                   + std::string(tok_pB));
 
+    size_t filter_mb = unique_filter_mb(opts);
+    if (opt_unique_ && filter_mb > 0)
+      unique_filter_ = new bloom_filter(filter_mb << 23);
+
     spot::srand(opt_seed_);
   }
 
@@ -488,6 +530,7 @@ namespace spot
   randltlgenerator::~randltlgenerator()
   {
     delete rf_;
+    delete unique_filter_;
   }
 
   formula randltlgenerator::next()
@@ -513,7 +556,16 @@ namespace spot
         if (opt_simpl_level_)
           f = simpl_.simplify(f);
 
-        if (opt_unique_ && !unique_set_.insert(f).second)
+        if (opt_unique_ && unique_filter_)
+          {
+            // Formula ids are reused once a formula is destroyed,
+            // so hash the formula's text instead.
+            std::string s = str_psl(f);
+            if (!unique_filter_->insert(fnv_hash(s.begin(), s.end()),
+                                        std::hash<std::string>()(s)))
+              ignore = true;
+          }
+        else if (opt_unique_ && !unique_set_.insert(f).second)
           ignore = true;
       } while (ignore && --trials);
     if (trials <= 0)
@@ -32,6 +32,8 @@
 
 namespace spot
 {
+  class bloom_filter;
+
   /// \ingroup tl_io
   /// \brief Base class for random formula generators
   class SPOT_API random_formula
@@ -293,6 +295,21 @@ namespace spot
     random_sere rs;
   };
 
+  /// \ingroup tl_io
+  /// \brief Generate random formulas according to an option_map.
+  ///
+  /// Unless the \c unique option is 0, the generated formulas are
+  /// all different.  By default this remembers all the formulas
+  /// generated so far.  If the \c unique_filter option is set to a
+  /// positive number N, a Bloom filter of N megabytes is used
+  /// instead, so that memory stays bounded even when generating
+  /// billions of formulas, at the cost of rejecting (and replacing)
+  /// a few formulas that were not generated before.  In that case
+  /// the caches of the simplifier are also bounded to the size of
+  /// the Bloom filter.  The \c simpl_cache_size option can be set to
+  /// a number of kilobytes to choose another bound (see
+  /// tl_simplifier_options::cache_size_limit), or to -1 to disable
+  /// it.
   class SPOT_API randltlgenerator
   {
     typedef std::unordered_set<formula> fset_t;
@@ -327,6 +344,7 @@ namespace spot
 
   private:
     fset_t unique_set_;
+    bloom_filter* unique_filter_ = nullptr;
     atomic_prop_set aprops_;
 
     int opt_seed_;
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2011-2019 Laboratoire de Recherche et Developpement
+// Copyright (C) 2011-2020 Laboratoire de Recherche et Developpement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -32,8 +32,11 @@
 #include <spot/tl/print.hh>
 #include <spot/tl/snf.hh>
 #include <spot/tl/length.hh>
+#include <spot/tl/apcollect.hh>
 #include <spot/twa/formula2bdd.hh>
 #include <spot/misc/minato.hh>
+#include <spot/misc/hash.hh>
+#include <spot/priv/lrucache.hh>
 #include <cassert>
 #include <memory>
 
@@ -44,15 +47,20 @@ namespace spot
   // The name of this class is public, but not its contents.
   class tl_simplifier_cache final
   {
-    typedef std::unordered_map<formula, formula> f2f_map;
-    typedef std::unordered_map<formula, bdd> f2b_map;
+    typedef lru_cache<formula, formula> f2f_map;
+    typedef lru_cache<formula, bdd> f2b_map;
     typedef std::map<int, formula> b2f_map;
+    typedef std::unordered_map<formula, int> f2v_map;
     typedef std::pair<formula, formula> pairf;
-    typedef std::map<pairf, bool> syntimpl_cache_t;
+    typedef lru_cache<pairf, bool, pair_hash> syntimpl_cache_t;
   public:
     bdd_dict_ptr dict;
     tl_simplifier_options options;
     language_containment_checker lcc;
+    // Whether tl_simplifier::as_bdd() has returned a BDD that may
+    // use the variables of non-Boolean subformulae.  These variables
+    // are then only released by clear_as_bdd_cache().
+    bool f2v_exported = false;
 
     ~tl_simplifier_cache()
     {
@@ -70,19 +78,33 @@ namespace spot
     {
       options.containment_checks |= options.containment_checks_stronger;
       options.event_univ |= options.favor_event_univ;
+      budget_.limit = options.cache_size_limit;
+    }
+
+    template<class Cache>
+    static void
+    print_cache_stats(std::ostream& os, const char* name, const Cache& c)
+    {
+      os << name << c.size() << " entries, " << c.hits() << " hits, "
+         << c.misses() << " misses, " << c.evictions() << " evictions\n";
     }
 
     void
     print_stats(std::ostream& os) const
     {
-      os << "simplified formulae:    " << simplified_.size() << " entries\n"
-         << "negative normal form:   " << nenoform_.size() << " entries\n"
-         << "syntactic implications: " << syntimpl_.size() << " entries\n"
-         << "boolean to bdd:         " << as_bdd_.size() << " entries\n"
-         << "star normal form:       " << snf_cache_.size() << " entries\n"
-         << "boolean isop:           " << bool_isop_.size() << " entries\n"
-         << "as dnf:                 " << as_dnf_.size() << " entries\n"
-         << "as cnf:                 " << as_cnf_.size() << " entries\n";
+      print_cache_stats(os, "simplified formulae:    ", simplified_);
+      print_cache_stats(os, "negative normal form:   ", nenoform_);
+      print_cache_stats(os, "syntactic implications: ", syntimpl_);
+      print_cache_stats(os, "boolean to bdd:         ", as_bdd_);
+      os << "star normal form:       " << snf_cache_.size() << " entries\n";
+      print_cache_stats(os, "boolean isop:           ", bool_isop_);
+      print_cache_stats(os, "as dnf:                 ", as_dnf_);
+      print_cache_stats(os, "as cnf:                 ", as_cnf_);
+      os << "containment automata:   " << lcc.memory_used() << " bytes\n";
+      os << "estimated cache memory: " << budget_.used << " bytes";
+      if (budget_.limit)
+        os << " (limit: " << budget_.limit << " bytes)";
+      os << '\n';
     }
 
     void
@@ -91,7 +113,30 @@ namespace spot
       as_bdd_.clear();
       for (auto p: bdd_to_f_)
         dict->unregister_variable(p.first, this);
+      budget_.used -= f2v_bytes * f2v_.size();
       bdd_to_f_.clear();
+      f2v_.clear();
+      f2v_exported = false;
+    }
+
+    // The variables allocated by as_bdd() to non-Boolean
+    // subformulae cannot be evicted one by one, as cached BDDs may
+    // refer to them.  When they use more than half of the budget,
+    // flush them with all the BDDs, unless some of them have been
+    // returned by tl_simplifier::as_bdd().  This must only be called
+    // between two simplifications, when the simplifier itself does
+    // not hold such a BDD.
+    // The automata of the language containment checker are flushed
+    // in the same way when they use more than the whole budget.
+    void
+    trim_as_bdd_cache()
+    {
+      if (!budget_.limit)
+        return;
+      if (!f2v_exported && f2v_bytes * f2v_.size() > budget_.limit / 2)
+        clear_as_bdd_cache();
+      if (lcc.memory_used() > budget_.limit)
+        lcc.clear();
     }
 
     // Convert a Boolean formula into a BDD for easier comparison.
@@ -99,9 +144,8 @@ namespace spot
     as_bdd(formula f)
     {
       // Lookup the result in case it has already been computed.
-      f2b_map::const_iterator it = as_bdd_.find(f);
-      if (it != as_bdd_.end())
-        return it->second;
+      if (const bdd* b = as_bdd_.find(f))
+        return *b;
 
       bdd result = bddfalse;
 
@@ -144,15 +188,24 @@ namespace spot
           }
         default:
           {
-            unsigned var = dict->register_anonymous_variables(1, this);
-            bdd_to_f_[var] = f;
-            result = bdd_ithvar(var);
+            // The variable associated to a non-Boolean subformula
+            // must survive the eviction of f from as_bdd_, as other
+            // cached BDDs may refer to it.
+            auto p = f2v_.emplace(f, 0);
+            if (p.second)
+              {
+                unsigned var = dict->register_anonymous_variables(1, this);
+                bdd_to_f_[var] = f;
+                p.first->second = var;
+                budget_.used += f2v_bytes;
+              }
+            result = bdd_ithvar(p.first->second);
             break;
           }
         }
 
       // Cache the result before returning.
-      as_bdd_[f] = result;
+      as_bdd_.insert(f, result);
       return result;
     }
 
@@ -213,21 +266,19 @@ namespace spot
 
     formula as_dnf(formula f)
     {
-      auto i = as_dnf_.find(f);
-      if (i != as_dnf_.end())
-        return i->second;
+      if (const formula* i = as_dnf_.find(f))
+        return *i;
       formula r = as_xnf(f, false);
-      as_dnf_[f] = r;
+      as_dnf_.insert(f, r);
       return r;
     }
 
     formula as_cnf(formula f)
     {
-      auto i = as_cnf_.find(f);
-      if (i != as_cnf_.end())
-        return i->second;
+      if (const formula* i = as_cnf_.find(f))
+        return *i;
       formula r = as_xnf(f, true);
-      as_cnf_[f] = r;
+      as_cnf_.insert(f, r);
       return r;
     }
 
@@ -236,16 +287,15 @@ namespace spot
     formula
     lookup_nenoform(formula f)
     {
-      f2f_map::const_iterator i = nenoform_.find(f);
-      if (i == nenoform_.end())
-        return nullptr;
-      return i->second;
+      if (const formula* i = nenoform_.find(f))
+        return *i;
+      return nullptr;
     }
 
     void
     cache_nenoform(formula orig, formula nenoform)
     {
-      nenoform_[orig] = nenoform;
+      nenoform_.insert(orig, nenoform);
     }
 
     // Return true iff the option set (syntactic implication
@@ -352,55 +402,85 @@ namespace spot
     formula
     lookup_simplified(formula f)
     {
-      f2f_map::const_iterator i = simplified_.find(f);
-      if (i == simplified_.end())
-        return nullptr;
-      return i->second;
+      if (const formula* i = simplified_.find(f))
+        return *i;
+      return nullptr;
     }
 
     void
     cache_simplified(formula orig, formula simplified)
     {
-      simplified_[orig] = simplified;
+      simplified_.insert(orig, simplified);
     }
 
     formula
     star_normal_form(formula f)
     {
-      return spot::star_normal_form(f, &snf_cache_);
+      std::size_t before = snf_cache_.size();
+      formula res = spot::star_normal_form(f, &snf_cache_);
+      account_snf(snf_cache_, before);
+      return res;
     }
 
     formula
     star_normal_form_bounded(formula f)
     {
-      return spot::star_normal_form_bounded(f, &snfb_cache_);
+      std::size_t before = snfb_cache_.size();
+      formula res = spot::star_normal_form_bounded(f, &snfb_cache_);
+      account_snf(snfb_cache_, before);
+      return res;
     }
 
 
     formula
     boolean_to_isop(formula f)
     {
-      f2f_map::const_iterator it = bool_isop_.find(f);
-      if (it != bool_isop_.end())
-        return it->second;
+      if (const formula* it = bool_isop_.find(f))
+        return *it;
 
       assert(f.is_boolean());
       formula res = bdd_to_formula(as_bdd(f), dict);
-      bool_isop_[f] = res;
+      bool_isop_.insert(f, res);
       return res;
     }
 
   private:
-    f2b_map as_bdd_;
+    // Estimated size of an entry in f2v_ plus its counterpart in
+    // bdd_to_f_, and of an entry in an snf_cache.
+    static constexpr std::size_t f2v_bytes =
+      sizeof(f2v_map::value_type) + sizeof(b2f_map::value_type)
+      + 8 * sizeof(void*);
+    static constexpr std::size_t snf_bytes =
+      sizeof(snf_cache::value_type) + 4 * sizeof(void*);
+
+    // The star-normal-form caches are filled by
+    // spot::star_normal_form() itself, so we cannot evict their
+    // entries one by one.  Instead, account for their growth, and
+    // flush them if the budget is exceeded.
+    void
+    account_snf(snf_cache& c, std::size_t before)
+    {
+      budget_.used += (c.size() - before) * snf_bytes;
+      if (budget_.exceeded())
+        {
+          budget_.used -= c.size() * snf_bytes;
+          c.clear();
+        }
+    }
+
+    // Must be declared before the caches that use it.
+    cache_budget budget_;
+    f2b_map as_bdd_{&budget_};
     b2f_map bdd_to_f_;
-    f2f_map simplified_;
-    f2f_map as_dnf_;
-    f2f_map as_cnf_;
-    f2f_map nenoform_;
-    syntimpl_cache_t syntimpl_;
+    f2v_map f2v_;
+    f2f_map simplified_{&budget_};
+    f2f_map as_dnf_{&budget_};
+    f2f_map as_cnf_{&budget_};
+    f2f_map nenoform_{&budget_};
+    syntimpl_cache_t syntimpl_{&budget_};
     snf_cache snf_cache_;
     snf_cache snfb_cache_;
-    f2f_map bool_isop_;
+    f2f_map bool_isop_{&budget_};
   };
 
 
@@ -2447,6 +2527,80 @@ namespace spot
         return bo;
       }
 
+      // Implication-based rewritings for And/Or operators that have
+      // more than opt_.wide_multop_threshold operands.
+      //
+      // Rather than checking each operand against the conjunction
+      // (or disjunction) of all others, we only compare pairs of
+      // operands, and use an index of atomic propositions so that
+      // only pairs sharing at least one proposition are considered.
+      // For And:
+      //   if fi => !fj, then fi & fj & ... = false
+      //   if fi => fj,  then fj can be removed
+      // For Or:
+      //   if !fi => fj, then fi | fj | ... = true
+      //   if fi => fj,  then fi can be removed
+      formula
+        reduce_wide_multop(formula mo)
+      {
+        bool is_and = mo.is(op::And);
+        unsigned mos = mo.size();
+        std::vector<atomic_prop_set> aps(mos);
+        std::unordered_map<formula, std::vector<unsigned>> ap_index;
+        for (unsigned i = 0; i < mos; ++i)
+          {
+            atomic_prop_collect(mo[i], &aps[i]);
+            for (formula ap: aps[i])
+              ap_index[ap].push_back(i);
+          }
+
+        std::vector<bool> removed(mos, false);
+        // seen[j] == i iff the pair (i,j) has already been checked.
+        std::vector<unsigned> seen(mos, -1U);
+        bool changed = false;
+        for (unsigned i = 0; i < mos; ++i)
+          {
+            // A removed operand must not cause the removal of
+            // another one: the operand that made it redundant might
+            // be the one removed next.
+            if (removed[i])
+              continue;
+            formula fi = mo[i];
+            for (formula ap: aps[i])
+              {
+                for (unsigned j: ap_index[ap])
+                  {
+                    if (j <= i || removed[j] || seen[j] == i)
+                      continue;
+                    seen[j] = i;
+                    formula fj = mo[j];
+                    if (c_->implication_neg(fi, fj, is_and)
+                        || c_->implication_neg(fj, fi, is_and))
+                      return is_and ? formula::ff() : formula::tt();
+                    if (c_->implication(fi, fj))
+                      removed[is_and ? j : i] = true;
+                    else if (c_->implication(fj, fi))
+                      removed[is_and ? i : j] = true;
+                    else
+                      continue;
+                    changed = true;
+                    if (removed[i])
+                      break;
+                  }
+                if (removed[i])
+                  break;
+              }
+          }
+        if (!changed)
+          return mo;
+        vec res;
+        res.reserve(mos);
+        for (unsigned i = 0; i < mos; ++i)
+          if (!removed[i])
+            res.emplace_back(mo[i]);
+        return formula::multop(mo.kind(), std::move(res));
+      }
+
       formula
         visit_multop(formula mo)
       {
@@ -2458,7 +2612,16 @@ namespace spot
         unsigned mos = mo.size();
 
         if ((opt_.synt_impl | opt_.containment_checks)
-            && mo.is(op::Or, op::And))
+            && mo.is(op::Or, op::And)
+            && opt_.wide_multop_threshold
+            && mos > opt_.wide_multop_threshold)
+          {
+            formula r = reduce_wide_multop(mo);
+            if (r != mo)
+              return recurse(r);
+          }
+        else if ((opt_.synt_impl | opt_.containment_checks)
+                 && mo.is(op::Or, op::And))
           {
             // Do not merge these two loops, as rewritings from the
             // second loop could prevent rewritings from the first one
@@ -3984,12 +4147,8 @@ namespace spot
       return false;
 
     // Cache lookup
-    {
-      pairf p(f, g);
-      syntimpl_cache_t::const_iterator i = syntimpl_.find(p);
-      if (i != syntimpl_.end())
-        return i->second;
-    }
+    if (const bool* i = syntimpl_.find(pairf(f, g)))
+      return *i;
 
     bool result;
 
@@ -3999,12 +4158,9 @@ namespace spot
       result = syntactic_implication_aux(f, g);
 
     // Cache result
-    {
-      pairf p(f, g);
-      syntimpl_[p] = result;
-      // std::cerr << str_psl(f) << (result ? " ==> " : " =/=> ")
-      //           << str_psl(g) << std::endl;
-    }
+    syntimpl_.insert(pairf(f, g), result);
+    // std::cerr << str_psl(f) << (result ? " ==> " : " =/=> ")
+    //           << str_psl(g) << std::endl;
 
     return result;
   }
@@ -4052,6 +4208,7 @@ namespace spot
   formula
   tl_simplifier::simplify(formula f)
   {
+    cache_->trim_as_bdd_cache();
     if (!f.is_in_nenoform())
       f = negative_normal_form(f, false);
     return simplify_recursively(f, cache_);
@@ -4091,6 +4248,8 @@ namespace spot
   bdd
   tl_simplifier::as_bdd(formula f)
   {
+    if (!f.is_boolean())
+      cache_->f2v_exported = true;
     return cache_->as_bdd(f);
   }
 
@@ -1,6 +1,6 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2011-2017, 2019 Laboratoire de Recherche et Developpement
-// de l'Epita (LRDE).
+// Copyright (C) 2011-2017, 2019, 2020 Laboratoire de Recherche et
+// Developpement de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
 //
@@ -46,7 +46,9 @@ namespace spot
         nenoform_stop_on_boolean(nenoform_stop_on_boolean),
         reduce_size_strictly(reduce_size_strictly),
         boolean_to_isop(boolean_to_isop),
-        favor_event_univ(favor_event_univ)
+        favor_event_univ(favor_event_univ),
+        wide_multop_threshold(0),
+        cache_size_limit(0)
     {
     }
 
@@ -87,6 +89,24 @@ namespace spot
     bool boolean_to_isop;
     // Try to isolate subformulae that are eventual and universal.
     bool favor_event_univ;
+    // If non-zero, n-ary And/Or with more operands than this will
+    // only have their operands checked pairwise for implications,
+    // considering only pairs that share some atomic proposition.
+    // This misses some rewritings, but avoids the quadratic number
+    // of implication checks against all-but-one subformulae that
+    // makes very wide formulae expensive to simplify.
+    unsigned wide_multop_threshold;
+    // If non-zero, an estimate of the maximum number of bytes used
+    // by the caches of the simplifier.  Least recently used entries
+    // are evicted to stay below this limit.  This is useful when a
+    // tl_simplifier instance is used for a long time.  (The BDD
+    // variables allocated to non-Boolean subformulae can only be
+    // released all at once, and this is done at the start of
+    // simplify() if they use more than half of this limit, and
+    // if none of them was returned by tl_simplifier::as_bdd().  The
+    // automata built for containment checks are also released all
+    // at once, when they use more than this limit.)
+    size_t cache_size_limit;
   };
 
   // fwd declaration to hide technical details.
@@ -150,6 +170,13 @@ namespace spot
     ///
     /// If you plan to use this method, be sure to pass a bdd_dict
     /// to the constructor.
+    ///
+    /// If \a f is not Boolean, its non-Boolean subformulae are
+    /// represented by anonymous BDD variables.  The returned BDD
+    /// may then only be used until the next call to
+    /// clear_as_bdd_cache() or clear_caches(), which release these
+    /// variables.  They are not released when the caches exceed
+    /// tl_simplifier_options::cache_size_limit.
     bdd as_bdd(formula f);
 
     /// \brief Clear the as_bdd() cache.
@@ -181,7 +208,12 @@ namespace spot
     /// arguments.
     formula boolean_to_isop(formula f);
 
-    /// Dump statistics about the caches.
+    /// \brief Dump statistics about the caches.
+    ///
+    /// For each cache, this displays its number of entries, and the
+    /// number of hits, misses, and evictions.  The estimated memory
+    /// used by all caches is also displayed, to be compared with
+    /// tl_simplifier_options::cache_size_limit.
     void print_stats(std::ostream& os) const;
 
   private:
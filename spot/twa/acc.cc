@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2015-2019 Laboratoire de Recherche et Développement
+// Copyright (C) 2015-2020 Laboratoire de Recherche et Développement
 // de l'Epita.
 //
 // This file is part of Spot, a model checking library.
@@ -23,6 +23,7 @@
 #include <sstream>
 #include <set>
 #include <cctype>
+#include <algorithm>
 #include <cstring>
 #include <map>
 #include <spot/twa/acc.hh>
@@ -400,6 +401,189 @@ namespace spot
     return !maybe_accepting(inf, {}).is_false();
   }
 
+  namespace
+  {
+    typedef std::vector<std::pair<acc_cond::mark_t, acc_cond::mark_t>>
+      acc_clauses;
+
+    // Above this number of clauses, a normal form is not worth it.
+    static constexpr unsigned max_compiled_clauses = 32;
+
+    // In both normal forms, a clause whose sets are included in
+    // those of another clause makes the latter redundant.  Also
+    // remove duplicates.
+    static void
+    absorb_clauses(acc_clauses& cl)
+    {
+      std::stable_sort(cl.begin(), cl.end(),
+                       [](const std::pair<acc_cond::mark_t,
+                                          acc_cond::mark_t>& a,
+                          const std::pair<acc_cond::mark_t,
+                                          acc_cond::mark_t>& b)
+                       {
+                         return (a.first.count() + a.second.count())
+                           < (b.first.count() + b.second.count());
+                       });
+      acc_clauses res;
+      for (auto& c: cl)
+        {
+          bool redundant = false;
+          for (auto& r: res)
+            if (r.first.subset(c.first) && r.second.subset(c.second))
+              {
+                redundant = true;
+                break;
+              }
+          if (!redundant)
+            res.push_back(c);
+        }
+      std::swap(cl, res);
+    }
+
+    // Compute in RES the clauses of the disjunctive (or conjunctive
+    // if CNF is set) normal form of the formula rooted at POS.
+    // Return false if this needs more than max_compiled_clauses
+    // clauses.
+    static bool
+    to_clauses(const acc_cond::acc_word* pos, bool cnf, acc_clauses& res)
+    {
+      res.clear();
+      auto op = pos->sub.op;
+      switch (op)
+        {
+        case acc_cond::acc_op::And:
+        case acc_cond::acc_op::Or:
+          {
+            // In a DNF, Or concatenates clauses while And combines
+            // them.  This is the converse in a CNF.
+            bool concat = (op == acc_cond::acc_op::Or) != cnf;
+            if (!concat)
+              res.emplace_back(acc_cond::mark_t({}), acc_cond::mark_t({}));
+            auto sub = pos - pos->sub.size;
+            acc_clauses tmp;
+            while (sub < pos)
+              {
+                --pos;
+                if (!to_clauses(pos, cnf, tmp))
+                  return false;
+                if (concat)
+                  {
+                    res.insert(res.end(), tmp.begin(), tmp.end());
+                  }
+                else
+                  {
+                    acc_clauses prod;
+                    prod.reserve(res.size() * tmp.size());
+                    for (auto& a: res)
+                      for (auto& b: tmp)
+                        prod.emplace_back(a.first | b.first,
+                                          a.second | b.second);
+                    std::swap(res, prod);
+                  }
+                absorb_clauses(res);
+                if (res.size() > max_compiled_clauses)
+                  return false;
+                pos -= pos->sub.size;
+              }
+            return true;
+          }
+        case acc_cond::acc_op::Inf:
+          if (cnf)
+            for (unsigned s: pos[-1].mark.sets())
+              res.emplace_back(acc_cond::mark_t({s}), acc_cond::mark_t({}));
+          else
+            res.emplace_back(pos[-1].mark, acc_cond::mark_t({}));
+          return res.size() <= max_compiled_clauses;
+        case acc_cond::acc_op::Fin:
+          if (cnf)
+            res.emplace_back(acc_cond::mark_t({}), pos[-1].mark);
+          else
+            for (unsigned s: pos[-1].mark.sets())
+              res.emplace_back(acc_cond::mark_t({}), acc_cond::mark_t({s}));
+          return res.size() <= max_compiled_clauses;
+        case acc_cond::acc_op::FinNeg:
+        case acc_cond::acc_op::InfNeg:
+          return false;
+        }
+      SPOT_UNREACHABLE();
+      return false;
+    }
+  }
+
+  acc_cond::compiled_code*
+  acc_cond::compiled_code::compile(const acc_code& code)
+  {
+    auto res = new compiled_code;
+    // An empty conjunction is true.
+    if (code.empty())
+      return res;
+    acc_clauses dnf;
+    acc_clauses cnf;
+    bool has_dnf = to_clauses(&code.back(), false, dnf);
+    bool has_cnf = to_clauses(&code.back(), true, cnf);
+    if (has_dnf && (!has_cnf || dnf.size() <= cnf.size()))
+      {
+        res->cnf = false;
+        std::swap(res->clauses, dnf);
+      }
+    else if (has_cnf)
+      {
+        std::swap(res->clauses, cnf);
+      }
+    else
+      {
+        res->interpret = true;
+      }
+    return res;
+  }
+
+  const acc_cond::compiled_code*
+  acc_cond::compile_() const
+  {
+    const compiled_code* res = compiled_code::compile(code_);
+    const compiled_code* old = nullptr;
+    // Another thread may have been faster.
+    if (!compiled_.compare_exchange_strong(old, res,
+                                           std::memory_order_acq_rel))
+      {
+        delete res;
+        res = old;
+      }
+    return res;
+  }
+
+  trival
+  acc_cond::compiled_code::maybe_accepting(mark_t infinitely_often,
+                                           mark_t always_present) const
+  {
+    // Same semantics as partial_eval(), applied to each clause.
+    infinitely_often |= always_present;
+    if (cnf)
+      {
+        trival res = true;
+        for (auto& c: clauses)
+          {
+            if ((c.first & infinitely_often)
+                || (c.second - infinitely_often))
+              continue;
+            if (!(c.second - always_present))
+              return false;
+            res = trival::maybe();
+          }
+        return res;
+      }
+    trival res = false;
+    for (auto& c: clauses)
+      {
+        if ((c.first - infinitely_often) || (c.second & always_present))
+          continue;
+        if (!(c.second & infinitely_often))
+          return true;
+        res = trival::maybe();
+      }
+    return res;
+  }
+
 
   acc_cond::mark_t acc_cond::accepting_sets(mark_t inf) const
   {
@@ -897,6 +1081,13 @@ namespace spot
 
   acc_cond::acc_code
   acc_cond::acc_code::random(unsigned n_accs, double reuse)
+  {
+    return random(default_random_generator(), n_accs, reuse);
+  }
+
+  acc_cond::acc_code
+  acc_cond::acc_code::random(random_generator& gen,
+                             unsigned n_accs, double reuse)
   {
     // With 0 acceptance sets, we always generate the true acceptance.
     // (Working with false is somehow pointless, and the formulas we
@@ -909,8 +1100,8 @@ namespace spot
     codes.reserve(n_accs);
     for (unsigned i = 0; i < n_accs; ++i)
       {
-        codes.emplace_back(drand() < 0.5 ? inf({i}) : fin({i}));
-        if (reuse > 0.0 && drand() < reuse)
+        codes.emplace_back(gen.drand() < 0.5 ? inf({i}) : fin({i}));
+        if (reuse > 0.0 && gen.drand() < reuse)
           --i;
       }
 
@@ -918,13 +1109,13 @@ namespace spot
     while (s > 1)
       {
         // Pick a random code and put it at the end
-        int p1 = mrand(s--);
+        int p1 = gen.mrand(s--);
         if (p1 != s) // https://gcc.gnu.org/bugzilla//show_bug.cgi?id=59603
           std::swap(codes[p1], codes[s]);
         // and another one
-        int p2 = mrand(s);
+        int p2 = gen.mrand(s);
 
-        if (drand() < 0.5)
+        if (gen.drand() < 0.5)
           codes[p2] |= std::move(codes.back());
         else
           codes[p2] &= std::move(codes.back());
@@ -2089,7 +2280,7 @@ namespace spot
       return n;
     }
 
-    static unsigned parse_range(const char*& str)
+    static unsigned parse_range(const char*& str, random_generator& gen)
     {
       skip_space(str);
       int min;
@@ -2135,7 +2326,7 @@ namespace spot
 
       if (min > max)
         std::swap(min, max);
-      return spot::rrand(min, max);
+      return gen.rrand(min, max);
     }
 
     static unsigned parse_par_num(const char*& input)
@@ -2210,7 +2401,7 @@ namespace spot
       return res;
     }
 
-    static bool max_or_min(const char*& input)
+    static bool max_or_min(const char*& input, random_generator& gen)
     {
       skip_space(input);
       if (!strncmp(input, "max", 3))
@@ -2226,19 +2417,19 @@ namespace spot
       if (!strncmp(input, "rand", 4))
         {
           input += 4;
-          return drand() < 0.5;
+          return gen.drand() < 0.5;
         }
       if (!strncmp(input, "random", 6))
         {
           input += 6;
-          return drand() < 0.5;
+          return gen.drand() < 0.5;
         }
       syntax_error(input, "expecting 'min', 'max', or 'rand'.");
       SPOT_UNREACHABLE();
       return false;
     }
 
-    static bool odd_or_even(const char*& input)
+    static bool odd_or_even(const char*& input, random_generator& gen)
     {
       skip_space(input);
       if (!strncmp(input, "odd", 3))
@@ -2254,12 +2445,12 @@ namespace spot
       if (!strncmp(input, "rand", 4))
         {
           input += 4;
-          return drand() < 0.5;
+          return gen.drand() < 0.5;
         }
       if (!strncmp(input, "random", 6))
         {
           input += 6;
-          return drand() < 0.5;
+          return gen.drand() < 0.5;
         }
       syntax_error(input, "expecting 'odd', 'even', or 'rand'.");
       SPOT_UNREACHABLE();
@@ -2269,6 +2460,11 @@ namespace spot
   }
 
   acc_cond::acc_code::acc_code(const char* input)
+    : acc_code(input, default_random_generator())
+  {
+  }
+
+  acc_cond::acc_code::acc_code(const char* input, random_generator& gen)
   {
     skip_space(input);
     acc_cond::acc_code c;
@@ -2295,22 +2491,22 @@ namespace spot
     else if (!strncmp(input, "generalized-Buchi", 17))
       {
         input += 17;
-        c = acc_cond::acc_code::generalized_buchi(parse_range(input));
+        c = acc_cond::acc_code::generalized_buchi(parse_range(input, gen));
       }
     else if (!strncmp(input, "generalized-co-Buchi", 20))
       {
         input += 20;
-        c = acc_cond::acc_code::generalized_co_buchi(parse_range(input));
+        c = acc_cond::acc_code::generalized_co_buchi(parse_range(input, gen));
       }
     else if (!strncmp(input, "Rabin", 5))
       {
         input += 5;
-        c = acc_cond::acc_code::rabin(parse_range(input));
+        c = acc_cond::acc_code::rabin(parse_range(input, gen));
       }
     else if (!strncmp(input, "Streett", 7))
       {
         input += 7;
-        c = acc_cond::acc_code::streett(parse_range(input));
+        c = acc_cond::acc_code::streett(parse_range(input, gen));
       }
     else if (!strncmp(input, "generalized-Rabin", 17))
       {
@@ -2320,7 +2516,7 @@ namespace spot
         v.reserve(num);
         while (num > 0)
           {
-            v.emplace_back(parse_range(input));
+            v.emplace_back(parse_range(input, gen));
             --num;
           }
         c = acc_cond::acc_code::generalized_rabin(v.begin(), v.end());
@@ -2328,21 +2524,21 @@ namespace spot
     else if (!strncmp(input, "parity", 6))
       {
         input += 6;
-        bool max = max_or_min(input);
-        bool odd = odd_or_even(input);
-        unsigned num = parse_range(input);
+        bool max = max_or_min(input, gen);
+        bool odd = odd_or_even(input, gen);
+        unsigned num = parse_range(input, gen);
         c = acc_cond::acc_code::parity(max, odd, num);
       }
     else if (!strncmp(input, "random", 6))
       {
         input += 6;
-        unsigned n = parse_range(input);
+        unsigned n = parse_range(input, gen);
         skip_space(input);
         auto setreuse = input;
         double reuse = (*input) ? parse_proba(input) : 0.0;
         if (reuse >= 1.0)
           syntax_error(setreuse, "probability for set reuse should be <1.");
-        c = acc_cond::acc_code::random(n, reuse);
+        c = acc_cond::acc_code::random(gen, n, reuse);
       }
     else
       {
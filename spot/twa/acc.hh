@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2014-2019 Laboratoire de Recherche et Développement
+// Copyright (C) 2014-2020 Laboratoire de Recherche et Développement
 // de l'Epita.
 //
 // This file is part of Spot, a model checking library.
@@ -19,10 +19,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <sstream>
 #include <vector>
 #include <iostream>
+#include <memory>
 
 #include <spot/misc/_config.h>
 #include <spot/misc/bitset.hh>
@@ -30,6 +32,8 @@
 
 namespace spot
 {
+  class random_generator;
+
   namespace internal
   {
     class mark_container;
@@ -78,12 +82,22 @@ namespace spot
     /// (i.e., the size of the bit vector) supported is a compile-time
     /// constant.  It can be changed by passing an option to the
     /// configure script of Spot.
+    ///
+    /// When Spot is configured with --enable-wide-marks, a mark_t
+    /// only stores inline the sets below 63, and the marks using
+    /// larger sets (up to max_accsets()) are stored out of line (see
+    /// spot::wide_bitset).  Automata with few acceptance sets then
+    /// do not pay for the large maximum.
     struct mark_t :
       public internal::_32acc<SPOT_MAX_ACCSETS == 8*sizeof(unsigned)>
     {
     private:
       // configure guarantees that SPOT_MAX_ACCSETS % (8*sizeof(unsigned)) == 0
+#if SPOT_WIDE_MARKS
+      typedef wide_bitset<SPOT_MAX_ACCSETS / (8*sizeof(unsigned))> _value_t;
+#else
       typedef bitset<SPOT_MAX_ACCSETS / (8*sizeof(unsigned))> _value_t;
+#endif
       _value_t id;
 
       mark_t(_value_t id) noexcept
@@ -207,7 +221,7 @@ namespace spot
 
       bool has(unsigned u) const
       {
-        return !!this->operator&(mark_t({0}) << u);
+        return u < max_accsets() && id.test(u);
       }
 
       void set(unsigned u)
@@ -234,7 +248,7 @@ namespace spot
 
       mark_t& operator-=(mark_t r)
       {
-        id &= ~r.id;
+        id = id.andnot(r.id);
         return *this;
       }
 
@@ -256,7 +270,7 @@ namespace spot
 
       mark_t operator-(mark_t r) const
       {
-        return id & ~r.id;
+        return id.andnot(r.id);
       }
 
       mark_t operator~() const
@@ -330,7 +344,7 @@ namespace spot
       /// subset of those represented by \a m.
       bool subset(mark_t m) const
       {
-        return !((*this) - m);
+        return id.subset(m.id);
       }
 
       /// \brief Whether the set of bits represented by *this is a
@@ -370,13 +384,28 @@ namespace spot
           return 0;
       }
 
+      /// \brief The number of the lowest set used that is greater than
+      /// or equal to \a s, plus one.
+      ///
+      /// If there is no such set, this returns 0.
+      /// If the sets {1,3,8} are used, min_set_from(2) returns 4.
+      unsigned min_set_from(unsigned s) const
+      {
+        unsigned res = id.lowest_from(s);
+        return res < max_accsets() ? res + 1 : 0;
+      }
+
       /// \brief A mark_t where all bits have been removed except the
       /// lowest one.
       ///
       /// For instance if this contains {1,3,8}, the output is {1}.
       mark_t lowest() const
       {
-        return id & -id;
+        if (!id)
+          return *this;
+        mark_t res = _value_t::zero();
+        res.id.set(id.lowest());
+        return res;
       }
 
       /// \brief Remove n bits that where set.
@@ -393,15 +422,8 @@ namespace spot
       template<class iterator>
       void fill(iterator here) const
       {
-        auto a = *this;
-        unsigned level = 0;
-        while (a)
-          {
-            if (a.has(0))
-              *here++ = level;
-            ++level;
-            a >>= 1;
-          }
+        for (unsigned s = min_set(); s; s = min_set_from(s))
+          *here++ = s - 1;
       }
 
       /// Returns some iterable object that contains the used sets.
@@ -843,6 +865,15 @@ namespace spot
       /// are left with a single tree.
       static acc_code random(unsigned n, double reuse = 0.0);
 
+      /// \brief Build a random acceptance condition, drawing from
+      /// \a gen.
+      ///
+      /// This is the same as the above function, except that random
+      /// numbers are drawn from \a gen instead of the global
+      /// generator used by spot::srand() and friends.
+      static acc_code random(random_generator& gen,
+                             unsigned n, double reuse = 0.0);
+
       /// \brief Conjunct the current condition in place with \a r.
       acc_code& operator&=(const acc_code& r)
       {
@@ -1312,8 +1343,19 @@ namespace spot
       /// "generalized-Rabin 4 2 1", etc.).
       ///
       /// A spot::parse_error is thrown on syntax error.
+      ///
+      /// Ranges such as "Rabin 1..3" and the "rand" keywords in
+      /// "parity rand rand 3" or "random 2" draw from the global
+      /// generator used by spot::srand() and friends.
       acc_code(const char* input);
 
+      /// \brief Construct an acc_code from a string, drawing from
+      /// \a gen.
+      ///
+      /// Same as above, except that the random choices are drawn
+      /// from \a gen.
+      acc_code(const char* input, random_generator& gen);
+
       /// \brief Build an empty acceptance formula.
       ///
       /// This is the same as t().
@@ -1371,20 +1413,29 @@ namespace spot
       all_ = o.all_;
       code_ = o.code_;
       uses_fin_acceptance_ = o.uses_fin_acceptance_;
+      discard_compiled_();
       return *this;
     }
 
     ~acc_cond()
     {
+      discard_compiled_();
     }
 
     /// \brief Change the acceptance formula.
     ///
     /// Beware, this does not change the number of declared sets.
+    ///
+    /// This is the only way to modify the acceptance formula of an
+    /// existing acc_cond, so that the compiled form used by
+    /// accepting(), inf_satisfiable(), and maybe_accepting() can be
+    /// discarded.  As with any other modification, this should not
+    /// be done while other threads use this acc_cond.
     void set_acceptance(const acc_code& code)
     {
       code_ = code;
       uses_fin_acceptance_ = check_fin_acceptance();
+      discard_compiled_();
     }
 
     /// \brief Retrieve the acceptance formula
@@ -1393,12 +1444,6 @@ namespace spot
       return code_;
     }
 
-    /// \brief Retrieve the acceptance formula
-    acc_code& get_acceptance()
-    {
-      return code_;
-    }
-
     bool operator==(const acc_cond& other) const
     {
       return other.num_sets() == num_ && other.get_acceptance() == code_;
@@ -1808,6 +1853,8 @@ namespace spot
     /// infinitely often satisfies the acceptance condition.
     bool accepting(mark_t inf) const
     {
+      if (const compiled_code* c = compiled())
+        return c->accepting(inf);
       return code_.accepting(inf);
     }
 
@@ -1818,6 +1865,8 @@ namespace spot
     /// set will never make the condition satisfiable.
     bool inf_satisfiable(mark_t inf) const
     {
+      if (const compiled_code* c = compiled())
+        return !c->maybe_accepting(inf, {}).is_false();
       return code_.inf_satisfiable(inf);
     }
 
@@ -1834,6 +1883,8 @@ namespace spot
     /// - trival::maybe() the SCC could contain an accepting cycle.
     trival maybe_accepting(mark_t infinitely_often, mark_t always_present) const
     {
+      if (const compiled_code* c = compiled())
+        return c->maybe_accepting(infinitely_often, always_present);
       return code_.maybe_accepting(infinitely_often, always_present);
     }
 
@@ -2021,6 +2072,59 @@ namespace spot
     acc_code code_;
     bool uses_fin_acceptance_ = false;
 
+    // A flattened version of code_, as a list of clauses that can
+    // be evaluated with a few bitwise operations each.  In
+    // disjunctive form, a clause (i, f) stands for Inf(i) &
+    // Fin({f1}) & Fin({f2}) & ... where f1, f2, ... are the sets of
+    // f.  In conjunctive form, it stands for Inf({i1}) | Inf({i2}) |
+    // ... | Fin(f).  The smallest of both forms is used.  If both
+    // have too many clauses, interpret is set, and code_ should be
+    // used instead.
+    struct SPOT_API compiled_code
+    {
+      bool interpret = false;
+      bool cnf = true;
+      std::vector<std::pair<mark_t, mark_t>> clauses;
+
+      bool accepting(mark_t inf) const
+      {
+        if (cnf)
+          {
+            for (auto& c: clauses)
+              if (!(c.first & inf) && !(c.second - inf))
+                return false;
+            return true;
+          }
+        for (auto& c: clauses)
+          if (c.first.subset(inf) && !(c.second & inf))
+            return true;
+        return false;
+      }
+
+      trival maybe_accepting(mark_t infinitely_often,
+                             mark_t always_present) const;
+
+      static compiled_code* compile(const acc_code& code);
+    };
+    // The compiled form is built on first use.  Several threads may
+    // use the same acc_cond concurrently, so it is published
+    // atomically by compile_().  It is not shared between copies.
+    mutable std::atomic<const compiled_code*> compiled_{nullptr};
+
+    const compiled_code* compile_() const;
+
+    const compiled_code* compiled() const
+    {
+      const compiled_code* c = compiled_.load(std::memory_order_acquire);
+      if (SPOT_UNLIKELY(!c))
+        c = compile_();
+      return c->interpret ? nullptr : c;
+    }
+
+    void discard_compiled_()
+    {
+      delete compiled_.exchange(nullptr, std::memory_order_relaxed);
+    }
   };
 
   struct rs_pairs_view {
@@ -2119,34 +2223,37 @@ namespace spot
       typedef std::forward_iterator_tag iterator_category;
 
       mark_iterator() noexcept
-        : m_({})
+        : m_({}), next_(0)
       {
       }
 
       mark_iterator(acc_cond::mark_t m) noexcept
-        : m_(m)
+        : m_(m), next_(m.min_set())
       {
       }
 
+      // Only iterators over the same mark can be compared.
       bool operator==(mark_iterator m) const
       {
-        return m_ == m.m_;
+        return next_ == m.next_;
       }
 
       bool operator!=(mark_iterator m) const
       {
-        return m_ != m.m_;
+        return next_ != m.next_;
       }
 
       value_type operator*() const
       {
-        SPOT_ASSERT(m_);
-        return m_.min_set() - 1;
+        SPOT_ASSERT(next_);
+        return next_ - 1;
       }
 
+      // M_ is not modified, so that no new mark is built (this
+      // matters with --enable-wide-marks).
       mark_iterator& operator++()
       {
-        m_.clear(this->operator*());
+        next_ = m_.min_set_from(next_);
         return *this;
       }
 
@@ -2158,6 +2265,7 @@ namespace spot
       }
     private:
       acc_cond::mark_t m_;
+      unsigned next_;           // Current set plus one, or 0 at the end.
     };
 
     class SPOT_API mark_container
@@ -51,6 +51,27 @@ namespace spot
     get_dict()->unregister_all_my_variables(this);
   }
 
+  void
+  twa::succ_batch(const state* s, std::vector<twa_succ_record>& out) const
+  {
+    for (auto i: succ(s))
+      out.push_back({i->dst(), i->cond(), i->acc()});
+  }
+
+  void
+  twa::pack_state(const state*, std::uint64_t*) const
+  {
+    throw std::runtime_error("pack_state() is not supported by this "
+                             "automaton");
+  }
+
+  const state*
+  twa::unpack_state(const std::uint64_t*) const
+  {
+    throw std::runtime_error("unpack_state() is not supported by this "
+                             "automaton");
+  }
+
 
   namespace
   {
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <spot/twa/fwd.hh>
 #include <spot/twa/acc.hh>
 #include <spot/twa/bdddict.hh>
@@ -34,6 +35,7 @@
 #include <vector>
 #include <spot/misc/casts.hh>
 #include <spot/misc/hash.hh>
+#include <spot/misc/openhash.hh>
 #include <spot/tl/formula.hh>
 #include <spot/misc/trival.hh>
 
@@ -196,6 +198,63 @@ namespace spot
   using state_map = std::unordered_map<const state*, val,
                                        state_ptr_hash, state_ptr_equal>;
 
+  /// \brief Open-addressing set of abstract states
+  ///
+  /// This is more compact and faster than state_set, but inserting
+  /// or erasing a state invalidates all iterators over the set.
+  /// Destroying each state if needed is the user's responsibility.
+  typedef open_hash_set<const state*,
+                        state_ptr_hash, state_ptr_equal> state_open_set;
+
+  /// \brief Open-addressing map of abstract states
+  ///
+  /// This is more compact and faster than state_map, but inserting
+  /// or erasing a state invalidates all iterators, pointers, and
+  /// references to the elements of the map.  Destroying each state
+  /// if needed is the user's responsibility.
+  template<class val>
+  using state_open_map = open_hash_map<const state*, val,
+                                       state_ptr_hash, state_ptr_equal>;
+
+#ifndef SWIG
+  /// \brief A state in its packed representation
+  ///
+  /// This holds the \a N words written by twa::pack_state() for
+  /// automata whose twa::packed_state_words() is \a N, so that
+  /// states can be stored inline in a hash table.
+  template<unsigned N>
+  struct packed_state
+  {
+    std::uint64_t words[N];
+
+    bool operator==(const packed_state& other) const noexcept
+    {
+      for (unsigned i = 0; i < N; ++i)
+        if (words[i] != other.words[i])
+          return false;
+      return true;
+    }
+  };
+
+  /// \brief Hash a packed_state.
+  template<unsigned N>
+  struct packed_state_hash
+  {
+    size_t operator()(const packed_state<N>& s) const noexcept
+    {
+      return fnv_hash(s.words, s.words + N);
+    }
+  };
+
+  /// \brief Open-addressing map of packed states
+  ///
+  /// The packed states are stored inline: unlike state_open_map,
+  /// this does not keep any state object.
+  template<unsigned N, class val>
+  using packed_state_open_map = open_hash_map<packed_state<N>, val,
+                                              packed_state_hash<N>>;
+#endif
+
   /// \ingroup twa_essentials
   /// \brief Render state pointers unique via a hash table.
   class SPOT_API state_unicity_table
@@ -476,6 +535,22 @@ namespace spot
     ///@}
   };
 
+  /// \ingroup twa_essentials
+  /// \brief An outgoing edge, as returned by twa::succ_batch().
+  ///
+  /// As for twa_succ_iterator::dst(), the destination state has to
+  /// be destroyed (see state::destroy()) by the caller after it is no
+  /// longer used.
+  struct twa_succ_record
+  {
+    /// The destination state.
+    const state* dst;
+    /// The condition on the edge.
+    bdd cond;
+    /// The acceptance mark of the edge.
+    acc_cond::mark_t acc;
+  };
+
   namespace internal
   {
     /// \brief Helper structure to iterate over the successors of a
@@ -679,6 +754,64 @@ namespace spot
     }
  #endif
 
+#ifndef SWIG
+    /// \brief Append all the successors of \a s to \a out.
+    ///
+    /// This fills a contiguous array of successors, in the order in
+    /// which succ_iter() would list them, instead of requiring
+    /// several virtual calls per edge.  Existing elements of \a out
+    /// are kept, so that a depth-first search can store the
+    /// successors of all the states on its stack in one vector.
+    ///
+    /// The default implementation uses succ_iter(), so it is not
+    /// faster.  Subclasses that override it should also override
+    /// has_native_succ_batch().
+    virtual void
+    succ_batch(const state* s, std::vector<twa_succ_record>& out) const;
+
+    /// \brief Whether succ_batch() is faster than succ_iter().
+    ///
+    /// Algorithms may use this to decide which interface to use.
+    virtual bool has_native_succ_batch() const
+    {
+      return false;
+    }
+
+    /// \brief Size of the packed representation of the states, in
+    /// 64-bit words.
+    ///
+    /// Automata whose states can be encoded in a fixed number of
+    /// words return that number, so that algorithms may store the
+    /// packed states inline (for instance in a hash table) and
+    /// compare them with memcmp() instead of keeping heap-allocated
+    /// state objects and calling state::compare().  Two states have
+    /// the same packed representation iff they are equal.
+    ///
+    /// The default implementation returns 0, meaning that packed
+    /// states are not supported.
+    virtual unsigned packed_state_words() const
+    {
+      return 0;
+    }
+
+    /// \brief Write the packed representation of \a s.
+    ///
+    /// \a out should point to packed_state_words() words.  Unused
+    /// bits are set to 0.
+    ///
+    /// The default implementation throws std::runtime_error.
+    virtual void pack_state(const state* s, std::uint64_t* out) const;
+
+    /// \brief Build a state from its packed representation.
+    ///
+    /// \a in should have been filled by pack_state().  The returned
+    /// state should be destroyed (see state::destroy()) by the
+    /// caller after it is no longer used.
+    ///
+    /// The default implementation throws std::runtime_error.
+    virtual const state* unpack_state(const std::uint64_t* in) const;
+#endif
+
     /// \brief Release an iterator after usage.
     ///
     /// This iterator can then be reused by succ_iter() to avoid
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2014-2019 Laboratoire de Recherche et Développement
+// Copyright (C) 2014-2020 Laboratoire de Recherche et Développement
 // de l'Epita.
 //
 // This file is part of Spot, a model checking library.
@@ -124,31 +124,51 @@ namespace spot
     fixup(init_number_);
   }
 
-  void twa_graph::merge_edges()
+  namespace
+  {
+    // Number of edges above which merge_edges() uses
+    // sort_edges_srcfirst_() instead of sort_edges_().  See
+    // bench/mergeedges/ for the measurements this is based on.
+    constexpr unsigned merge_edges_srcfirst_threshold = 1024;
+  }
+
+  void twa_graph::merge_edges(parallel_policy ppolicy)
   {
     set_named_prop("highlight-edges", nullptr);
     g_.remove_dead_edges_();
     if (!is_existential())
       merge_univ_dests();
 
-    typedef graph_t::edge_storage_t tr_t;
-    g_.sort_edges_([](const tr_t& lhs, const tr_t& rhs)
-                   {
-                     if (lhs.src < rhs.src)
-                       return true;
-                     if (lhs.src > rhs.src)
-                       return false;
-                     if (lhs.dst < rhs.dst)
-                       return true;
-                     if (lhs.dst > rhs.dst)
-                       return false;
-                     return lhs.acc < rhs.acc;
-                     // Do not sort on conditions, we'll merge
-                     // them.
-                   });
-
+    // On large automata, sort the edges by source in linear time,
+    // and then sort the (usually short) list of successors of each
+    // state.  Both approaches produce the same order.
     auto& trans = this->edge_vector();
     unsigned orig_size = trans.size();
+    bool srcfirst = orig_size > merge_edges_srcfirst_threshold;
+    auto sort_edges = [&](auto lt, parallel_policy pp)
+      {
+        if (srcfirst)
+          g_.sort_edges_srcfirst_(lt, pp);
+        else
+          g_.sort_edges_(lt, pp);
+      };
+
+    typedef graph_t::edge_storage_t tr_t;
+    sort_edges([](const tr_t& lhs, const tr_t& rhs)
+               {
+                 if (lhs.src < rhs.src)
+                   return true;
+                 if (lhs.src > rhs.src)
+                   return false;
+                 if (lhs.dst < rhs.dst)
+                   return true;
+                 if (lhs.dst > rhs.dst)
+                   return false;
+                 return lhs.acc < rhs.acc;
+                 // Do not sort on conditions, we'll merge
+                 // them.
+               }, ppolicy);
+
     unsigned tend = orig_size;
     unsigned out = 0;
     unsigned in = 1;
@@ -194,22 +214,24 @@ namespace spot
     // both as Inf and Fin)
     if ((in < tend) && !acc().uses_fin_acceptance())
       {
-        typedef graph_t::edge_storage_t tr_t;
-        g_.sort_edges_([](const tr_t& lhs, const tr_t& rhs)
-                       {
-                         if (lhs.src < rhs.src)
-                           return true;
-                         if (lhs.src > rhs.src)
-                           return false;
-                         if (lhs.dst < rhs.dst)
-                           return true;
-                         if (lhs.dst > rhs.dst)
-                           return false;
-                         bdd_less_than_stable lt;
-                         return lt(lhs.cond, rhs.cond);
-                         // Do not sort on acceptance, we'll merge
-                         // them.
-                       });
+        sort_edges([](const tr_t& lhs, const tr_t& rhs)
+                   {
+                     if (lhs.src < rhs.src)
+                       return true;
+                     if (lhs.src > rhs.src)
+                       return false;
+                     if (lhs.dst < rhs.dst)
+                       return true;
+                     if (lhs.dst > rhs.dst)
+                       return false;
+                     bdd_less_than_stable lt;
+                     return lt(lhs.cond, rhs.cond);
+                     // Do not sort on acceptance, we'll merge
+                     // them.
+                   },
+                   // bdd_less_than_stable creates BDDs, so this
+                   // cannot be done in parallel.
+                   parallel_policy());
 
         for (; in < tend; ++in)
           {
@@ -233,7 +255,7 @@ namespace spot
           trans.resize(out);
       }
 
-    g_.chain_edges_();
+    g_.chain_edges_(ppolicy);
 
     // Did we actually reduce the number of edges?
     if (trans.size() != orig_size)
@@ -341,6 +363,16 @@ namespace spot
   }
 
   void twa_graph::purge_dead_states()
+  {
+    purge_dead_states_(false);
+  }
+
+  void twa_graph::purge_dead_states_and_merge_edges()
+  {
+    purge_dead_states_(true);
+  }
+
+  void twa_graph::purge_dead_states_(bool merge)
   {
     unsigned num_states = g_.num_states();
     std::vector<unsigned> useful(num_states, 0);
@@ -525,7 +557,11 @@ namespace spot
       else
         useful[s] = -1U;
     if (current == num_states)
-      return;                        // No useless state.
+      {
+        if (merge)
+          merge_edges();
+        return;                        // No useless state.
+      }
 
     // Removing some non-deterministic dead state could make the
     // automaton universal.  Likewise for non-complete.
@@ -534,10 +570,24 @@ namespace spot
     if (prop_complete().is_false())
       prop_complete(trival::maybe());
 
+    if (merge && is_existential())
+      {
+        // merge_edges() will sort the edges and rebuild the chains
+        // of successors, so there is no need to preserve them while
+        // removing states.
+        defrag_named_props_(useful, current);
+        init_number_ = useful[init_number_];
+        g_.defrag_states_unchained_(useful, current);
+        merge_edges();
+        return;
+      }
+
     defrag_states(std::move(useful), current);
 
     if (purge_unreachable_needed)
       purge_unreachable_states();
+    if (merge)
+      merge_edges();
   }
 
   void twa_graph::defrag_states(std::vector<unsigned>&& newst,
@@ -630,6 +680,14 @@ namespace spot
           fixup(e.dst);
       }
 
+    defrag_named_props_(newst, used_states);
+    init_number_ = newst[init_number_];
+    g_.defrag_states(std::move(newst), used_states);
+  }
+
+  void twa_graph::defrag_named_props_(const std::vector<unsigned>& newst,
+                                      unsigned used_states)
+  {
     if (auto* names = get_named_prop<std::vector<std::string>>("state-names"))
       {
         unsigned size = names->size();
@@ -691,8 +749,6 @@ namespace spot
               s = newst[s];
           }
       }
-    init_number_ = newst[init_number_];
-    g_.defrag_states(std::move(newst), used_states);
   }
 
   void twa_graph::remove_unused_ap()
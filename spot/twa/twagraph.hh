@@ -218,6 +218,11 @@ namespace spot
     graph_t g_;
     mutable unsigned init_number_;
 
+  private:
+    void purge_dead_states_(bool merge);
+    void defrag_named_props_(const std::vector<unsigned>& newst,
+                             unsigned used_states);
+
   public:
     twa_graph(const bdd_dict_ptr& dict)
       : twa(dict),
@@ -344,6 +349,43 @@ namespace spot
       return new twa_graph_succ_iterator<graph_t>(&g_, s->succ);
     }
 
+#ifndef SWIG
+    virtual void
+    succ_batch(const state* st,
+               std::vector<twa_succ_record>& out) const override
+    {
+      auto s = down_cast<const typename graph_t::state_storage_t*>(st);
+      SPOT_ASSERT(!s->succ || g_.is_valid_edge(s->succ));
+      for (unsigned t = s->succ; t; t = g_.edge_storage(t).next_succ)
+        {
+          auto& e = g_.edge_storage(t);
+          out.push_back({&g_.state_data(e.dst), e.cond, e.acc});
+        }
+    }
+
+    virtual bool has_native_succ_batch() const override
+    {
+      return true;
+    }
+
+    virtual unsigned packed_state_words() const override
+    {
+      return 1;
+    }
+
+    virtual void
+    pack_state(const state* st, std::uint64_t* out) const override
+    {
+      *out = state_number(st);
+    }
+
+    virtual const state*
+    unpack_state(const std::uint64_t* in) const override
+    {
+      return state_from_number(*in);
+    }
+#endif
+
     static constexpr bool is_univ_dest(const edge_storage_t& e)
     {
       return is_univ_dest(e.dst);
@@ -571,7 +613,12 @@ namespace spot
     ///
     /// If the automaton uses some universal edges, the method
     /// merge_univ_dests() is also called.
-    void merge_edges();
+    ///
+    /// On large automata, \a ppolicy allows the first sort of the
+    /// edges, and the final reconstruction of the chains of
+    /// successors, to use several threads.  The result does not
+    /// depend on the number of threads.
+    void merge_edges(parallel_policy ppolicy = parallel_policy());
 
     /// \brief Merge common universal destinations.
     ///
@@ -603,6 +650,16 @@ namespace spot
     /// \see purge_unreachable_states
     void purge_dead_states();
 
+    /// \brief Remove all dead states, and merge edges.
+    ///
+    /// This has the same effect as calling purge_dead_states()
+    /// followed by merge_edges(), but it is cheaper on existential
+    /// automata.  Since merge_edges() sorts the edges anyway, the
+    /// edge vector is compacted and its states renamed in a single
+    /// pass, without renumbering the edges nor maintaining the
+    /// chains of successors in between.
+    void purge_dead_states_and_merge_edges();
+
     /// \brief Remove all unreachable states.
     ///
     /// A state is unreachable if it cannot be reached from the
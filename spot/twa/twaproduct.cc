@@ -306,6 +306,11 @@ namespace spot
         left_kripke_ = false;
       }
 
+    left_words_ = left_->packed_state_words();
+    right_words_ = right_->packed_state_words();
+    if (!left_words_ || !right_words_)
+      left_words_ = right_words_ = 0;
+
     copy_ap_of(left_);
     copy_ap_of(right_);
 
@@ -355,6 +360,72 @@ namespace spot
       return new twa_succ_iterator_product(li, ri, this, p);
   }
 
+  void
+  twa_product::succ_batch(const state* state,
+                          std::vector<twa_succ_record>& out) const
+  {
+    const state_product* s = down_cast<const state_product*>(state);
+    left_succ_.clear();
+    right_succ_.clear();
+    left_->succ_batch(s->left(), left_succ_);
+    right_->succ_batch(s->right(), right_succ_);
+
+    // Use the same order as the iterators: the left successors
+    // vary faster.
+    fixed_size_pool* p = const_cast<fixed_size_pool*>(&pool_);
+    unsigned shift = left_acc().num_sets();
+    for (auto& r: right_succ_)
+      for (auto& l: left_succ_)
+        {
+          bdd cond = l.cond & r.cond;
+          if (cond == bddfalse)
+            continue;
+          auto dst = new(p->allocate()) state_product(l.dst->clone(),
+                                                      r.dst->clone(), p);
+          if (left_kripke_)
+            out.push_back({dst, cond, r.acc});
+          else
+            out.push_back({dst, cond, l.acc | (r.acc << shift)});
+        }
+    for (auto& l: left_succ_)
+      l.dst->destroy();
+    for (auto& r: right_succ_)
+      r.dst->destroy();
+  }
+
+  bool
+  twa_product::has_native_succ_batch() const
+  {
+    return left_->has_native_succ_batch() && right_->has_native_succ_batch();
+  }
+
+  unsigned
+  twa_product::packed_state_words() const
+  {
+    return left_words_ + right_words_;
+  }
+
+  void
+  twa_product::pack_state(const state* state, std::uint64_t* out) const
+  {
+    if (!left_words_)
+      return twa::pack_state(state, out);
+    const state_product* s = down_cast<const state_product*>(state);
+    left_->pack_state(s->left(), out);
+    right_->pack_state(s->right(), out + left_words_);
+  }
+
+  const state*
+  twa_product::unpack_state(const std::uint64_t* in) const
+  {
+    if (!left_words_)
+      return twa::unpack_state(in);
+    fixed_size_pool* p = const_cast<fixed_size_pool*>(&pool_);
+    return new(p->allocate()) state_product(left_->unpack_state(in),
+                                            right_->unpack_state
+                                            (in + left_words_), p);
+  }
+
   const acc_cond& twa_product::left_acc() const
   {
     return left_->acc();
@@ -95,6 +95,23 @@ namespace spot
     virtual twa_succ_iterator*
     succ_iter(const state* state) const override;
 
+#ifndef SWIG
+    virtual void
+    succ_batch(const state* state,
+               std::vector<twa_succ_record>& out) const override;
+
+    /// \brief Whether both operands have a native succ_batch().
+    virtual bool has_native_succ_batch() const override;
+
+    /// \brief The sum of the packed sizes of the operands, or 0 if
+    /// one of them does not support packed states.
+    virtual unsigned packed_state_words() const override;
+    virtual void pack_state(const state* s,
+                            std::uint64_t* out) const override;
+    virtual const state* unpack_state(const std::uint64_t* in)
+      const override;
+#endif
+
     virtual std::string format_state(const state* state) const override;
 
     virtual state* project_state(const state* s, const const_twa_ptr& t)
@@ -108,6 +125,13 @@ namespace spot
     const_twa_ptr right_;
     bool left_kripke_;
     fixed_size_pool pool_;
+    // Successors of the operands, used by succ_batch().
+    mutable std::vector<twa_succ_record> left_succ_;
+    mutable std::vector<twa_succ_record> right_succ_;
+    // Packed sizes of the operands, or 0 if one of them does not
+    // support packed states.
+    unsigned left_words_;
+    unsigned right_words_;
 
   private:
     // Disallow copy.
@@ -746,6 +746,38 @@ namespace spot
     return fmt.str();
   }
 
+  unsigned twa_univ_remover::packed_state_words() const
+  {
+    return (2 * aut_->num_states() + 63) / 64;
+  }
+
+  void twa_univ_remover::pack_state(const state* s, std::uint64_t* out) const
+  {
+    auto as = down_cast<const univ_remover_state*>(s);
+    std::fill(out, out + packed_state_words(), 0);
+    // The reset flag is not stored: it only tells whether the edge
+    // leading to the state is accepting, and compare() ignores it.
+    for (unsigned q : as->states())
+      {
+        unsigned bit = (int) q < 0 ? 2 * ~q + 1 : 2 * q;
+        out[bit / 64] |= std::uint64_t(1) << (bit % 64);
+      }
+  }
+
+  const state* twa_univ_remover::unpack_state(const std::uint64_t* in) const
+  {
+    std::set<unsigned> states;
+    unsigned ns = aut_->num_states();
+    for (unsigned s = 0; s < ns; ++s)
+      {
+        if (in[2 * s / 64] >> (2 * s % 64) & 1)
+          states.insert(s);
+        if (in[(2 * s + 1) / 64] >> ((2 * s + 1) % 64) & 1)
+          states.insert(~s);
+      }
+    return new univ_remover_state(states);
+  }
+
   twa_univ_remover_ptr remove_univ_otf(const const_twa_graph_ptr& aut)
   {
     assert(aut->acc().is_buchi());
@@ -145,6 +145,13 @@ namespace spot
     const state* get_init_state() const override;
     twa_succ_iterator* succ_iter(const state* s) const override;
     std::string format_state(const state* s) const override;
+#ifndef SWIG
+    // States are packed as two bits per state of the original
+    // automaton, to tell whether it appears marked or unmarked.
+    unsigned packed_state_words() const override;
+    void pack_state(const state* s, std::uint64_t* out) const override;
+    const state* unpack_state(const std::uint64_t* in) const override;
+#endif
   };
 
   typedef std::shared_ptr<twa_univ_remover> twa_univ_remover_ptr;
@@ -34,13 +34,17 @@ namespace
   static bool
   tr_t_less_than(const tr_t& t1, const tr_t& t2)
   {
-    return t1.cond.id() < t2.cond.id();
+    if (t1.cond.id() != t2.cond.id())
+      return t1.cond.id() < t2.cond.id();
+    return t1.acc < t2.acc;
   }
 
+  // Two edges match if they have the same label and the same
+  // acceptance sets.  Their destinations are checked separately.
   static bool
   operator!=(const tr_t& t1, const tr_t& t2)
   {
-    return t1.cond.id() != t2.cond.id();
+    return t1.cond.id() != t2.cond.id() || t1.acc != t2.acc;
   }
 
   static bool
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2015, 2017-2019 Laboratoire de Recherche et Développement
+// Copyright (C) 2015, 2017-2020 Laboratoire de Recherche et Développement
 // de l'Epita.
 //
 // This file is part of Spot, a model checking library.
@@ -83,7 +83,7 @@ namespace spot
       // condition but not in the automaton, the result is undefined.
 
       auto& acc = aut->acc();
-      auto& c = acc.get_acceptance();
+      auto c = acc.get_acceptance();
       acc_cond::mark_t used_in_cond = c.used_sets();
 
       if (!used_in_cond)
@@ -154,6 +154,7 @@ namespace spot
               break;
             }
         }
+      acc.set_acceptance(c);
       return aut;
     }
 
@@ -283,6 +283,10 @@ namespace spot
   ///       default), the MSCC will be traversed again (i.e. generating
   ///       the successors of the root recursively) for deletion. This
   ///       is a choice between memory and speed.
+  ///     - `packed` If set and shy is not, store the visited states
+  ///       using their packed representation, when the automaton
+  ///       supports it (see `twa::pack_state()`).  Only the states
+  ///       of the DFS stack are then kept as state objects.
   ///
   ///   Examples:
   ///   \code
@@ -292,6 +296,7 @@ namespace spot
   ///   Cou99(poprem)
   ///   Cou99(poprem shy !group)
   ///   Cou99(poprem shy group)
+  ///   Cou99(packed)
   ///   \endcode
   ///
   /// - `GC04` uses `spot::explicit_gv04_check()` and works on automata
@@ -317,12 +322,15 @@ namespace spot
   /// - `SE05` uses `spot::se05()` and works on work on automata with
   ///   Fin-less acceptance conditions using at most one acceptance
   ///   set.  Set option `bsh` to the size of a hash-table if you want
-  ///   to activate bit-state hashing.
+  ///   to activate bit-state hashing.  Set option `packed` to store
+  ///   the visited states using their packed representation, when
+  ///   the automaton supports it (see `spot::packed_se05_search()`).
   ///
   ///   Examples:
   ///   \code
   ///   SE05
   ///   SE05(bsh=4M)
+  ///   SE05(packed)
   ///   \endcode
   ///
   /// - `Tau03` uses `spot::explicit_tau03_search()` and work on automata with
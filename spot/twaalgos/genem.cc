@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2017-2019 Laboratoire de Recherche et Developpement
+// Copyright (C) 2017-2020 Laboratoire de Recherche et Developpement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -20,6 +20,7 @@
 #include "config.h"
 #include <spot/twaalgos/genem.hh>
 #include <spot/twaalgos/cleanacc.hh>
+#include <atomic>
 
 namespace spot
 {
@@ -28,15 +29,20 @@ namespace spot
     static bool
     is_scc_empty(const scc_info& si, unsigned scc,
                  const acc_cond& autacc, twa_run_ptr run,
-                 acc_cond::mark_t tocut = {});
+                 scc_info_workspace& ws, acc_cond::mark_t tocut = {});
 
     static bool
     scc_split_check(const scc_info& si, unsigned scc, const acc_cond& acc,
-                    twa_run_ptr run, acc_cond::mark_t tocut)
+                    twa_run_ptr run, scc_info_workspace& ws,
+                    acc_cond::mark_t tocut)
     {
       scc_and_mark_filter filt(si, scc, tocut);
-      filt.override_acceptance(acc);
-      scc_info upper_si(filt, scc_info_options::STOP_ON_ACC);
+      // Do not modify the automaton, so that several SCCs can be
+      // checked concurrently.
+      filt.use_acceptance(acc);
+      // The workspace makes the cost of this decomposition
+      // proportional to the size of the SCC.
+      scc_info upper_si(filt, scc_info_options::STOP_ON_ACC, ws);
 
       const int accepting_scc = upper_si.one_accepting_scc();
       if (accepting_scc >= 0)
@@ -49,7 +55,7 @@ namespace spot
         return true;
       unsigned nscc = upper_si.scc_count();
       for (unsigned scc = 0; scc < nscc; ++scc)
-        if (!is_scc_empty(upper_si, scc, acc, run, tocut))
+        if (!is_scc_empty(upper_si, scc, acc, run, ws, tocut))
           return false;
       return true;
     }
@@ -57,7 +63,7 @@ namespace spot
     static bool
     is_scc_empty(const scc_info& si, unsigned scc,
                  const acc_cond& autacc, twa_run_ptr run,
-                 acc_cond::mark_t tocut)
+                 scc_info_workspace& ws, acc_cond::mark_t tocut)
     {
       if (si.is_rejecting_scc(scc))
         return true;
@@ -69,7 +75,7 @@ namespace spot
         if (acc_cond::mark_t fu = disjunct.fin_unit())
           {
             if (!scc_split_check
-                (si, scc, disjunct.remove(fu, true), run, fu))
+                (si, scc, disjunct.remove(fu, true), run, ws, fu))
               return false;
           }
         else
@@ -81,10 +87,11 @@ namespace spot
             // Try to accept when Fin(fo) == true
             acc_cond::mark_t fo_m = {(unsigned) fo};
             if (!scc_split_check
-                (si, scc, disjunct.remove(fo_m, true), run, fo_m))
+                (si, scc, disjunct.remove(fo_m, true), run, ws, fo_m))
               return false;
             // Try to accept when Fin(fo) == false
-            if (!is_scc_empty(si, scc, disjunct.force_inf(fo_m), run, tocut))
+            if (!is_scc_empty(si, scc, disjunct.force_inf(fo_m),
+                              run, ws, tocut))
               return false;
           }
       return true;
@@ -92,7 +99,8 @@ namespace spot
 
     static bool
     generic_emptiness_check_main(const twa_graph_ptr& aut,
-                                 twa_run_ptr run)
+                                 twa_run_ptr run,
+                                 parallel_policy ppolicy = parallel_policy())
     {
       // We used to call cleanup_acceptance_here(aut, false),
       // but it turns out this is usually a waste of time.
@@ -114,7 +122,8 @@ namespace spot
       // scc_and_mark_filter will have no effect if fin_unit() is
       // empty.
       scc_and_mark_filter filt(aut, aut_acc.fin_unit());
-      scc_info si(filt, scc_info_options::STOP_ON_ACC);
+      scc_info_workspace ws;
+      scc_info si(filt, scc_info_options::STOP_ON_ACC, ws);
 
       const int accepting_scc = si.one_accepting_scc();
       if (accepting_scc >= 0)
@@ -124,24 +133,59 @@ namespace spot
           return false;
         }
 
+      if (!run && ppolicy.nthreads() > 1)
+        {
+          // Each thread needs its own workspace.  Stop checking new
+          // SCCs as soon as one is found non-empty.
+          std::vector<scc_info_workspace> wss(ppolicy.nthreads());
+          std::atomic<bool> nonempty(false);
+          parallel_for_each_scc(si, ppolicy,
+                                [&](unsigned scc, unsigned worker)
+                                {
+                                  if (!nonempty.load(std::memory_order_relaxed)
+                                      && !is_scc_empty(si, scc, aut_acc,
+                                                       nullptr, wss[worker]))
+                                    nonempty = true;
+                                });
+          return !nonempty;
+        }
+
       unsigned nscc = si.scc_count();
       for (unsigned scc = 0; scc < nscc; ++scc)
-        if (!is_scc_empty(si, scc, aut_acc, run))
+        if (!is_scc_empty(si, scc, aut_acc, run, ws))
           return false;
       return true;
     }
   }
 
-  bool generic_emptiness_check(const const_twa_graph_ptr& aut)
+  bool generic_emptiness_check(const const_twa_graph_ptr& aut,
+                               parallel_policy ppolicy)
   {
     if (SPOT_UNLIKELY(!aut->is_existential()))
       throw std::runtime_error("generic_emptiness_check() "
                                "does not support alternating automata");
     auto aut_ = std::const_pointer_cast<twa_graph>(aut);
-    acc_cond old = aut_->acc();
-    bool res = generic_emptiness_check_main(aut_, nullptr);
-    aut_->set_acceptance(old);
-    return res;
+    return generic_emptiness_check_main(aut_, nullptr, ppolicy);
+  }
+
+  bool generic_emptiness_check(const scc_and_mark_filter& filt)
+  {
+    const_twa_graph_ptr aut = filt.get_aut();
+    if (SPOT_UNLIKELY(!aut->is_existential()))
+      throw std::runtime_error("generic_emptiness_check() "
+                               "does not support alternating automata");
+    const acc_cond& acc = filt.get_acceptance();
+    if (acc.is_f())
+      return true;
+    scc_info_workspace ws;
+    scc_info si(filt, scc_info_options::STOP_ON_ACC, ws);
+    if (si.one_accepting_scc() >= 0)
+      return false;
+    unsigned nscc = si.scc_count();
+    for (unsigned scc = 0; scc < nscc; ++scc)
+      if (!is_scc_empty(si, scc, acc, nullptr, ws))
+        return false;
+    return true;
   }
 
   twa_run_ptr generic_accepting_run(const const_twa_graph_ptr& aut)
@@ -150,10 +194,8 @@ namespace spot
       throw std::runtime_error("generic_accepting_run() "
                                "does not support alternating automata");
     auto aut_ = std::const_pointer_cast<twa_graph>(aut);
-    acc_cond old = aut_->acc();
     twa_run_ptr run = std::make_shared<twa_run>(aut_);
     bool res = generic_emptiness_check_main(aut_, run);
-    aut_->set_acceptance(old);
     if (!res)
       return run;
     return nullptr;
@@ -162,7 +204,15 @@ namespace spot
   bool generic_emptiness_check_for_scc(const scc_info& si,
                                        unsigned scc)
   {
-    return is_scc_empty(si, scc, si.get_aut()->acc(), nullptr);
+    scc_info_workspace ws;
+    return generic_emptiness_check_for_scc(si, scc, ws);
+  }
+
+  bool generic_emptiness_check_for_scc(const scc_info& si,
+                                       unsigned scc,
+                                       scc_info_workspace& ws)
+  {
+    return is_scc_empty(si, scc, si.acc(), nullptr, ws);
   }
 
   bool
@@ -171,7 +221,8 @@ namespace spot
   {
     if (si.is_trivial(scc))
       return true;
-    return scc_split_check(si, scc, forced_acc, nullptr, {});
+    scc_info_workspace ws;
+    return scc_split_check(si, scc, forced_acc, nullptr, ws, {});
   }
 
 }
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2017-2019 Laboratoire de Recherche et Developpement
+// Copyright (C) 2017-2020 Laboratoire de Recherche et Developpement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -30,9 +30,24 @@ namespace spot
   /// Currently only implemented for twa_graph automata, i.e., not automata
   /// constructed on-the-fly.
   ///
+  /// With a \a ppolicy allowing several threads, the SCCs of \a aut
+  /// are checked concurrently.
+  ///
   /// \cite baier.19.atva
   SPOT_API bool
-  generic_emptiness_check(const const_twa_graph_ptr& aut);
+  generic_emptiness_check(const const_twa_graph_ptr& aut,
+                          parallel_policy ppolicy = parallel_policy());
+
+  /// \ingroup emptiness_check_algorithms
+  /// \brief Emptiness check of a filtered automaton, for any
+  /// acceptance condition.
+  ///
+  /// This checks whether an accepting cycle can be reached from
+  /// filt.start_state() using only the edges kept by \a filt, with
+  /// the acceptance condition given by filt.get_acceptance().  The
+  /// automaton is not copied nor modified.
+  SPOT_API bool
+  generic_emptiness_check(const scc_and_mark_filter& filt);
 
   /// \ingroup emptiness_check_algorithms
   /// \brief Accepting run search in an automaton, for any acceptance condition.
@@ -51,6 +66,17 @@ namespace spot
   SPOT_API bool
   generic_emptiness_check_for_scc(const scc_info& si, unsigned scc);
 
+  /// \ingroup emptiness_check_algorithms
+  /// \brief Emptiness check of one SCC, for any acceptance condition.
+  ///
+  /// This version reuses the scratch memory of \a ws for the
+  /// decompositions of the SCC, so that checking all the SCCs of a
+  /// large automaton does not cost a pass over the whole automaton
+  /// for each of them.
+  SPOT_API bool
+  generic_emptiness_check_for_scc(const scc_info& si, unsigned scc,
+                                  scc_info_workspace& ws);
+
   /// \ingroup emptiness_check_algorithms
   /// \brief Emptiness check of one SCC, for any acceptance condition.
   ///
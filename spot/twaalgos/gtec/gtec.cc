@@ -39,7 +39,18 @@ namespace spot
 {
   namespace
   {
-    typedef std::pair<const spot::state*, twa_succ_iterator*> pair_state_iter;
+    // An element of the DFS stack of couvreur99_check::check().  If
+    // the automaton has a native twa::succ_batch(), the successors
+    // of S that remain to be processed are the elements [POS, END) of
+    // a vector shared by the whole stack, and IT is nullptr.
+    // Otherwise IT iterates over the successors of S.
+    struct dfs_item
+    {
+      const state* s;
+      twa_succ_iterator* it;
+      unsigned pos;
+      unsigned end;
+    };
   }
 
   couvreur99_check::couvreur99_check(const const_twa_ptr& a, option_map o)
@@ -151,12 +162,32 @@ namespace spot
     // * num, the number of visited nodes.  Used to set the order of each
     //   visited node,
     int num = 1;
-    // * todo, the depth-first search stack.  This holds pairs of the
-    //   form (STATE, ITERATOR) where ITERATOR is a twa_succ_iterator
-    //   over the successors of STATE.  In our use, ITERATOR should
-    //   always be freed when TODO is popped, but STATE should not because
-    //   it is also used as a key in H.
-    std::stack<pair_state_iter> todo;
+    // * todo, the depth-first search stack.  This holds items of the
+    //   form (STATE, SUCCESSORS) where SUCCESSORS are either a
+    //   twa_succ_iterator or a range of SUCCS over the successors of
+    //   STATE.  In our use, SUCCESSORS should always be freed when
+    //   TODO is popped, but STATE should not because it is also used
+    //   as a key in H.
+    std::vector<dfs_item> todo;
+    std::vector<twa_succ_record> succs;
+    bool batch = ecs_->aut->has_native_succ_batch();
+
+    auto push = [&](const state* s)
+      {
+        if (batch)
+          {
+            unsigned b = succs.size();
+            ecs_->aut->succ_batch(s, succs);
+            todo.push_back({s, nullptr, b, unsigned(succs.size())});
+          }
+        else
+          {
+            twa_succ_iterator* iter = ecs_->aut->succ_iter(s);
+            iter->first();
+            todo.push_back({s, iter, 0, 0});
+          }
+        inc_depth();
+      };
 
     // Setup depth-first search from the initial state.
     {
@@ -164,10 +195,7 @@ namespace spot
       ecs_->h[init] = 1;
       ecs_->root.push(1);
       arc.push({});
-      twa_succ_iterator* iter = ecs_->aut->succ_iter(init);
-      iter->first();
-      todo.emplace(init, iter);
-      inc_depth();
+      push(init);
     }
 
     while (!todo.empty())
@@ -175,16 +203,20 @@ namespace spot
         assert(ecs_->root.size() == arc.size());
 
         // We are looking at the next successor in SUCC.
-        twa_succ_iterator* succ = todo.top().second;
+        dfs_item& succ = todo.back();
 
         // If there is no more successor, backtrack.
-        if (succ->done())
+        if (succ.it ? succ.it->done() : succ.pos == succ.end)
           {
             // We have explored all successors of state CURR.
-            const state* curr = todo.top().first;
+            const state* curr = succ.s;
+            twa_succ_iterator* it = succ.it;
 
-            // Backtrack TODO.
-            todo.pop();
+            // Backtrack TODO.  The successors of the states of TODO
+            // are stored contiguously in SUCCS.
+            todo.pop_back();
+            if (!it)
+              succs.resize(todo.empty() ? 0 : todo.back().end);
             dec_depth();
 
             // If poprem is used, fill rem with any component removed,
@@ -208,7 +240,8 @@ namespace spot
                 remove_component(curr);
                 ecs_->root.pop();
               }
-            ecs_->aut->release_iter(succ);
+            if (it)
+              ecs_->aut->release_iter(it);
             // Do not destroy CURR: it is a key in H.
             continue;
           }
@@ -216,12 +249,22 @@ namespace spot
         // We have a successor to look at.
         inc_transitions();
         // Fetch the values (destination state, acceptance conditions
-        // of the arc) we are interested in...
-        const state* dest = succ->dst();
-        acc_cond::mark_t acc = succ->acc();
-        // ... and point the iterator to the next successor, for
-        // the next iteration.
-        succ->next();
+        // of the arc) we are interested in, and point SUCC to the
+        // next successor, for the next iteration.
+        const state* dest;
+        acc_cond::mark_t acc;
+        if (succ.it)
+          {
+            dest = succ.it->dst();
+            acc = succ.it->acc();
+            succ.it->next();
+          }
+        else
+          {
+            const twa_succ_record& r = succs[succ.pos++];
+            dest = r.dst;
+            acc = r.acc;
+          }
         // We do not need SUCC from now on.
 
         // Are we going to a new state?
@@ -232,10 +275,7 @@ namespace spot
             // successors for later processing.
             ecs_->root.push(++num);
             arc.push(acc);
-            twa_succ_iterator* iter = ecs_->aut->succ_iter(dest);
-            iter->first();
-            todo.emplace(dest, iter);
-            inc_depth();
+            push(dest);
             continue;
           }
         dest->destroy();
@@ -279,11 +319,16 @@ namespace spot
         if (ecs_->aut->acc().accepting(ecs_->root.top().condition))
           {
             // We have found an accepting SCC.
-            // Release all iterators in TODO.
+            // Release all iterators and successors in TODO.
             while (!todo.empty())
               {
-                ecs_->aut->release_iter(todo.top().second);
-                todo.pop();
+                dfs_item& item = todo.back();
+                if (item.it)
+                  ecs_->aut->release_iter(item.it);
+                else
+                  for (unsigned j = item.pos; j < item.end; ++j)
+                    succs[j].dst->destroy();
+                todo.pop_back();
                 dec_depth();
               }
             // Use this state to start the computation of an accepting
@@ -315,14 +360,265 @@ namespace spot
 
   //////////////////////////////////////////////////////////////////////
 
+  namespace
+  {
+    // A version of couvreur99_check that stores the visited states
+    // by their packed representation (see twa::pack_state()) inline
+    // in an open-addressing table, so that only the states of the
+    // DFS stack are kept as state objects.
+    //
+    // The fully processed states of the SCCs of ROOT_ are stored in
+    // a single stack REM_, where the states of the SCC ROOT_[i] are
+    // those from position ROOT_[i].rem: merging SCCs does not have
+    // to move any state, and removing a dead SCC just truncates REM_.
+    // (So the "poprem" option is ignored.)
+    //
+    // The couvreur99_check_status needed to compute a counterexample
+    // is only built, by unpacking the visited states, once an
+    // accepting SCC has been found.
+    template<unsigned N>
+    class couvreur99_packed_check final: public couvreur99_check
+    {
+    public:
+      couvreur99_packed_check(const const_twa_ptr& a, option_map o)
+        : couvreur99_check(a, o)
+      {
+        assert(a->packed_state_words() == N);
+      }
+
+      virtual emptiness_check_result_ptr check() override
+      {
+        const_twa_ptr aut = ecs_->aut;
+        {
+          auto acc = aut->acc();
+          if (acc.get_acceptance().is_f())
+            return nullptr;
+          if (acc.uses_fin_acceptance())
+            throw std::runtime_error
+              ("Fin acceptance is not supported by couvreur99()");
+        }
+
+        h_.clear();
+        root_.clear();
+        rem_.clear();
+        // This is the same algorithm as couvreur99_check::check(),
+        // except that the states of TODO are not keys of H_: they
+        // are destroyed when they are popped.
+        std::stack<acc_cond::mark_t> arc;
+        int num = 1;
+        std::vector<dfs_item> todo;
+        std::vector<twa_succ_record> succs;
+        bool batch = aut->has_native_succ_batch();
+
+        auto push = [&](const state* s)
+          {
+            if (batch)
+              {
+                unsigned b = succs.size();
+                aut->succ_batch(s, succs);
+                todo.push_back({s, nullptr, b, unsigned(succs.size())});
+              }
+            else
+              {
+                twa_succ_iterator* iter = aut->succ_iter(s);
+                iter->first();
+                todo.push_back({s, iter, 0, 0});
+              }
+            inc_depth();
+          };
+
+        // Setup depth-first search from the initial state.
+        {
+          const state* init = aut->get_init_state();
+          h_.emplace(pack(init), 1);
+          root_.push_back({1, {}, 0});
+          arc.push({});
+          push(init);
+        }
+
+        while (!todo.empty())
+          {
+            assert(root_.size() == arc.size());
+
+            dfs_item& succ = todo.back();
+
+            // If there is no more successor, backtrack.
+            if (succ.it ? succ.it->done() : succ.pos == succ.end)
+              {
+                const state* curr = succ.s;
+                twa_succ_iterator* it = succ.it;
+                todo.pop_back();
+                if (it)
+                  aut->release_iter(it);
+                else
+                  succs.resize(todo.empty() ? 0 : todo.back().end);
+                dec_depth();
+
+                packed_state<N> p = pack(curr);
+                curr->destroy();
+                rem_.push_back(p);
+                inc_depth();
+                // When backtracking the root of an SCC, all the
+                // states of that SCC are dead.
+                assert(!root_.empty());
+                if (root_.back().index == h_.find(p)->second)
+                  {
+                    assert(!arc.empty());
+                    arc.pop();
+                    remove_component();
+                  }
+                continue;
+              }
+
+            inc_transitions();
+            const state* dest;
+            acc_cond::mark_t acc;
+            if (succ.it)
+              {
+                dest = succ.it->dst();
+                acc = succ.it->acc();
+                succ.it->next();
+              }
+            else
+              {
+                const twa_succ_record& r = succs[succ.pos++];
+                dest = r.dst;
+                acc = r.acc;
+              }
+
+            // Are we going to a new state?
+            packed_state<N> p = pack(dest);
+            auto i = h_.emplace(p, num + 1);
+            if (i.second)
+              {
+                root_.push_back({++num, {}, rem_.size()});
+                arc.push(acc);
+                push(dest);
+                continue;
+              }
+            dest->destroy();
+
+            // If we have reached a dead component, ignore it.
+            int threshold = i.first->second;
+            if (threshold == -1)
+              continue;
+
+            // Merge all the SCCs above the one of DEST.
+            while (threshold < root_.back().index)
+              {
+                assert(!arc.empty());
+                acc |= root_.back().condition;
+                acc |= arc.top();
+                root_.pop_back();
+                arc.pop();
+              }
+            root_.back().condition |= acc;
+
+            if (aut->acc().accepting(root_.back().condition))
+              {
+                // We have found an accepting SCC.
+                // Release all iterators, successors, and states in TODO.
+                while (!todo.empty())
+                  {
+                    dfs_item& item = todo.back();
+                    if (item.it)
+                      aut->release_iter(item.it);
+                    else
+                      for (unsigned j = item.pos; j < item.end; ++j)
+                        succs[j].dst->destroy();
+                    item.s->destroy();
+                    todo.pop_back();
+                    dec_depth();
+                  }
+                set_states(h_.size());
+                unpack_status(p);
+                return std::make_shared<couvreur99_check_result>(ecs_,
+                                                                 options());
+              }
+          }
+        // This automaton recognizes no word.
+        set_states(h_.size());
+        return nullptr;
+      }
+
+      virtual std::ostream& print_stats(std::ostream& os) const override
+      {
+        os << h_.size() << " unique states visited" << std::endl;
+        os << root_.size()
+           << " strongly connected components in search stack\n";
+        os << transitions() << " transitions explored" << std::endl;
+        os << max_depth() << " items max in DFS search stack" << std::endl;
+        return os;
+      }
+
+    private:
+      struct scc
+      {
+        int index;
+        acc_cond::mark_t condition;
+        // Position in REM_ of the first state of this SCC.
+        size_t rem;
+      };
+
+      packed_state<N> pack(const state* s) const
+      {
+        packed_state<N> p;
+        ecs_->aut->pack_state(s, p.words);
+        return p;
+      }
+
+      // Mark the states of the SCC at the top of ROOT_ as dead, and
+      // pop it.
+      void remove_component()
+      {
+        ++removed_components;
+        size_t b = root_.back().rem;
+        dec_depth(rem_.size() - b);
+        for (size_t i = b; i < rem_.size(); ++i)
+          h_.find(rem_[i])->second = -1;
+        rem_.resize(b);
+        root_.pop_back();
+      }
+
+      // Fill a new couvreur99_check_status with the unpacked
+      // visited states and the SCCs of ROOT_, so that
+      // couvreur99_check_result can compute a counterexample from
+      // the state packed as SEED.
+      void unpack_status(const packed_state<N>& seed)
+      {
+        const_twa_ptr aut = ecs_->aut;
+        ecs_ = std::make_shared<couvreur99_check_status>(aut);
+        ecs_->h.reserve(h_.size());
+        for (auto& i: h_)
+          ecs_->h.emplace(aut->unpack_state(i.first.words), i.second);
+        for (auto& r: root_)
+          {
+            ecs_->root.push(r.index);
+            ecs_->root.top().condition = r.condition;
+          }
+        const state* s = aut->unpack_state(seed.words);
+        ecs_->cycle_seed = ecs_->h.find(s)->first;
+        s->destroy();
+      }
+
+      packed_state_open_map<N, int> h_; // the order of each visited state
+      std::vector<scc> root_;
+      std::vector<packed_state<N>> rem_;
+    };
+  }
+
+  //////////////////////////////////////////////////////////////////////
+
   couvreur99_check_shy::todo_item::todo_item(const state* s, int n,
                                              couvreur99_check_shy* shy)
         : s(s), n(n)
   {
-    for (auto iter: shy->ecs_->aut->succ(s))
+    auto& succs = shy->succs_;
+    succs.clear();
+    shy->ecs_->aut->succ_batch(s, succs);
+    for (auto& r: succs)
       {
-        q.emplace_back(iter->acc(),
-                       iter->dst());
+        q.emplace_back(r.acc, r.dst);
         shy->inc_depth();
         shy->inc_transitions();
       }
@@ -614,6 +910,20 @@ namespace spot
   {
     if (o.get("shy"))
       return SPOT_make_shared_enabled__(couvreur99_check_shy, a, o);
+    if (o.get("packed"))
+      switch (a->packed_state_words())
+        {
+        case 1:
+          return SPOT_make_shared_enabled__(couvreur99_packed_check<1>, a, o);
+        case 2:
+          return SPOT_make_shared_enabled__(couvreur99_packed_check<2>, a, o);
+        case 3:
+          return SPOT_make_shared_enabled__(couvreur99_packed_check<3>, a, o);
+        case 4:
+          return SPOT_make_shared_enabled__(couvreur99_packed_check<4>, a, o);
+        default:
+          break;
+        }
     return SPOT_make_shared_enabled__(couvreur99_check, a, o);
   }
 
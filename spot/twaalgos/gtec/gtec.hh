@@ -104,6 +104,12 @@ namespace spot
   /// \li \c "shy" : if non zero, then spot::couvreur99_check_shy is used,
   ///                otherwise (and by default) spot::couvreur99_check is used.
   ///
+  /// \li \c "packed" : if non zero, and if \c "shy" is not set, the
+  /// visited states are stored using their packed representation
+  /// (see twa::pack_state()) when the automaton supports it with at
+  /// most 4 words, so that only the states of the DFS stack are kept
+  /// as state objects.  The \c "poprem" option is then ignored.
+  ///
   /// \li \c "poprem" : specifies how the algorithm should handle the
   /// destruction of non-accepting maximal strongly connected
   /// components.  If \c poprem is non null, the algorithm will keep a
@@ -215,6 +221,8 @@ namespace spot
 
     typedef std::list<todo_item> todo_list;
     todo_list todo;
+    // Buffer for twa::succ_batch().
+    std::vector<twa_succ_record> succs_;
 
     void clear_todo();
 
@@ -43,7 +43,7 @@ namespace spot
     const_twa_ptr aut;
     scc_stack root;
 
-    state_map<int> h;
+    state_open_map<int> h;
 
     const state* cycle_seed;
 
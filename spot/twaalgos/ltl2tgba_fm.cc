@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2008-2019 Laboratoire de Recherche et Développement
+// Copyright (C) 2008-2020 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 // Copyright (C) 2003-2006 Laboratoire d'Informatique de Paris 6
 // (LIP6), département Systèmes Répartis Coopératifs (SRC), Université
@@ -29,6 +29,7 @@
 #include <spot/tl/apcollect.hh>
 #include <spot/tl/mark.hh>
 #include <cassert>
+#include <stdexcept>
 #include <memory>
 #include <utility>
 #include <algorithm>
@@ -105,17 +106,28 @@ namespace spot
     {
       typedef twa_graph::namer<formula> namer;
     public:
-      ratexp_to_dfa(translate_dict& dict);
+      ratexp_to_dfa(translate_dict* dict);
       std::tuple<const_twa_graph_ptr, const namer*, const state*>
       succ(formula f);
       ~ratexp_to_dfa();
 
+      // DFAs stored in an fm_fragment_store outlive the
+      // translate_dict that built them, and are later used by other
+      // translate_dict instances.
+      void
+      set_dict(translate_dict* dict)
+      {
+        dict_ = dict;
+      }
+
+      void clear();
+
     protected:
       typedef std::pair<twa_graph_ptr, const namer*> labelled_aut;
       labelled_aut translate(formula f);
 
     private:
-      translate_dict& dict_;
+      translate_dict* dict_;
       typedef std::unordered_map<formula, labelled_aut> f2a_t;
       std::vector<labelled_aut> automata_;
       f2a_t f2a_;
@@ -133,25 +145,10 @@ namespace spot
     public:
 
       translate_dict(twa_graph_ptr& a, tl_simplifier* ls, bool exprop,
-                     bool single_acc, bool unambiguous)
-        : a_(a),
-          dict(a->get_dict()),
-          ls(ls),
-          a_set(bddtrue),
-          var_set(bddtrue),
-          next_set(bddtrue),
-          transdfa(*this),
-          exprop(exprop),
-          single_acc(single_acc),
-          acc(a->acc()),
-          unambiguous(unambiguous)
-      {
-      }
+                     bool single_acc, bool unambiguous,
+                     fm_fragment_store* store);
 
-      ~translate_dict()
-      {
-        dict->unregister_all_my_variables(this);
-      }
+      ~translate_dict();
 
       twa_graph_ptr& a_;
       bdd_dict_ptr dict;
@@ -161,14 +158,24 @@ namespace spot
       typedef bdd_dict::fv_map fv_map;
       typedef std::vector<formula> vf_map;
 
-      fv_map next_map;               ///< Maps "Next" variables to BDD variables
-      vf_map next_formula_map; ///< Maps BDD variables to "Next" variables
+    private:
+      // The following are used only when no fm_fragment_store is given.
+      fv_map own_next_map_;
+      vf_map own_next_formula_map_;
+      ratexp_to_dfa own_transdfa_;
+      fm_fragment_store* store_;
+      // Owner of the "Next" variables: either this or store_.
+      const void* next_owner_;
+
+    public:
+      fv_map& next_map;           ///< Maps "Next" variables to BDD variables
+      vf_map& next_formula_map;   ///< Maps BDD variables to "Next" variables
 
       bdd a_set;
       bdd var_set;
       bdd next_set;
 
-      ratexp_to_dfa transdfa;
+      ratexp_to_dfa& transdfa;
       bool exprop;
       bool single_acc;
       acc_cond& acc;
@@ -183,6 +190,12 @@ namespace spot
           // in the hash function for flagged_formula.
           flags_mark_all = (1<<10),
           flags_recurring = (1<<14),
+          // The following flags are only used in the keys of an
+          // fm_fragment_store, as its translations are shared by
+          // translate_dict instances with different settings.
+          flags_exprop = (1<<18),
+          flags_single_acc = (1<<22),
+          flags_unambiguous = (1<<26),
         };
 
       struct flagged_formula
@@ -219,6 +232,8 @@ namespace spot
                          flagged_formula_hash> flagged_formula_to_bdd_map;
     private:
       flagged_formula_to_bdd_map ltl_bdd_;
+      // Flags added to the keys of store_.
+      unsigned store_flags_;
 
     public:
 
@@ -255,6 +270,15 @@ namespace spot
         return acc_cond::mark_t(t.begin(), t.end());
       }
 
+      void
+      use_a_variable(int num)
+      {
+        a_set &= bdd_ithvar(num);
+        auto p = bm.emplace(num, 0U);
+        if (p.second)
+          p.first->second = acc.add_set();
+      }
+
       int
       register_a_variable(formula f)
       {
@@ -262,11 +286,7 @@ namespace spot
           {
             int num = dict->register_acceptance_variable
               (formula::tt(), this);
-            a_set &= bdd_ithvar(num);
-
-            auto p = bm.emplace(num, 0U);
-            if (p.second)
-              p.first->second = acc.add_set();
+            use_a_variable(num);
             return num;
           }
         // A promise of 'x', noted P(x) is pretty much like the F(x)
@@ -309,11 +329,7 @@ namespace spot
                 // P(a M b) = P(a & b)
                 formula g = formula::And({f[0], f[1]});
                 int num = dict->register_acceptance_variable(g, this);
-                a_set &= bdd_ithvar(num);
-
-                auto p = bm.emplace(num, 0U);
-                if (p.second)
-                  p.first->second = acc.add_set();
+                use_a_variable(num);
                 return num;
               }
             else if (f.is(op::F))
@@ -327,12 +343,7 @@ namespace spot
               }
           }
         int num = dict->register_acceptance_variable(f, this);
-        a_set &= bdd_ithvar(num);
-
-        auto p = bm.emplace(num, 0U);
-        if (p.second)
-          p.first->second = acc.add_set();
-
+        use_a_variable(num);
         return num;
       }
 
@@ -348,7 +359,7 @@ namespace spot
           }
         else
           {
-            num = dict->register_anonymous_variables(1, this);
+            num = dict->register_anonymous_variables(1, next_owner_);
             next_map[f] = num;
             next_formula_map.resize(bdd_varnum());
             next_formula_map[num] = f;
@@ -472,10 +483,122 @@ namespace spot
         return formula::OrRat(std::move(v));
       }
 
+      // Register the variables used by a translation that may have
+      // been computed by another translate_dict sharing our
+      // fm_fragment_store, as if it had been computed here.
+      void
+      adopt(bdd b)
+      {
+        bdd sup = bdd_support(b);
+        while (sup != bddtrue)
+          {
+            int v = bdd_var(sup);
+            sup = bdd_high(sup);
+            const bdd_dict::bdd_info& i = dict->bdd_map[v];
+            switch (i.type)
+              {
+              case bdd_dict::var:
+                register_proposition(i.f);
+                a_->register_ap(i.f);
+                break;
+              case bdd_dict::acc:
+                dict->register_acceptance_variable(i.f, this);
+                use_a_variable(v);
+                break;
+              case bdd_dict::anon:
+                next_set &= bdd_ithvar(v);
+                break;
+              }
+          }
+      }
+
       const translated&
       ltl_to_bdd(formula f, bool mark_all, bool recurring = false);
 
     };
+  }
+
+  class fm_fragment_store final
+  {
+  public:
+    fm_fragment_store(const bdd_dict_ptr& dict)
+      : dict(dict), transdfa(nullptr)
+    {
+    }
+
+    ~fm_fragment_store()
+    {
+      clear();
+    }
+
+    void
+    clear()
+    {
+      ltl_bdd.clear();
+      transdfa.clear();
+      next_map.clear();
+      next_formula_map.clear();
+      dict->unregister_all_my_variables(this);
+    }
+
+    bdd_dict_ptr dict;
+    translate_dict::fv_map next_map;
+    translate_dict::vf_map next_formula_map;
+    translate_dict::flagged_formula_to_bdd_map ltl_bdd;
+    ratexp_to_dfa transdfa;
+  };
+
+  namespace
+  {
+    translate_dict::translate_dict(twa_graph_ptr& a, tl_simplifier* ls,
+                                   bool exprop, bool single_acc,
+                                   bool unambiguous,
+                                   fm_fragment_store* store)
+      : a_(a),
+        dict(a->get_dict()),
+        ls(ls),
+        own_transdfa_(this),
+        store_(store),
+        next_owner_(store ? static_cast<const void*>(store) : this),
+        next_map(store ? store->next_map : own_next_map_),
+        next_formula_map(store ? store->next_formula_map
+                         : own_next_formula_map_),
+        a_set(bddtrue),
+        var_set(bddtrue),
+        next_set(bddtrue),
+        transdfa(store ? store->transdfa : own_transdfa_),
+        exprop(exprop),
+        single_acc(single_acc),
+        acc(a->acc()),
+        unambiguous(unambiguous),
+        store_flags_((exprop ? flags_exprop : flags_none)
+                     | (single_acc ? flags_single_acc : flags_none)
+                     | (unambiguous ? flags_unambiguous : flags_none))
+    {
+      transdfa.set_dict(this);
+    }
+
+    translate_dict::~translate_dict()
+    {
+      if (store_)
+        {
+          // The translations we have added to the store may use
+          // these variables, so the store should keep them
+          // registered after we are gone.
+          bdd all = var_set & a_set;
+          while (all != bddtrue)
+            {
+              const bdd_dict::bdd_info& i = dict->bdd_map[bdd_var(all)];
+              if (i.type == bdd_dict::var)
+                dict->register_proposition(i.f, store_);
+              else if (i.type == bdd_dict::acc)
+                dict->register_acceptance_variable(i.f, store_);
+              all = bdd_high(all);
+            }
+          transdfa.set_dict(nullptr);
+        }
+      dict->unregister_all_my_variables(this);
+    }
 
 #ifdef __GNUC__
 #  define unused __attribute__((unused))
@@ -940,15 +1063,23 @@ namespace spot
     }
 
 
-    ratexp_to_dfa::ratexp_to_dfa(translate_dict& dict)
+    ratexp_to_dfa::ratexp_to_dfa(translate_dict* dict)
       : dict_(dict)
     {
     }
 
     ratexp_to_dfa::~ratexp_to_dfa()
+    {
+      clear();
+    }
+
+    void
+    ratexp_to_dfa::clear()
     {
       for (auto i: automata_)
         delete i.second;
+      automata_.clear();
+      f2a_.clear();
     }
 
     ratexp_to_dfa::labelled_aut
@@ -956,7 +1087,7 @@ namespace spot
     {
       assert(f.is_in_nenoform());
 
-      auto a = make_twa_graph(dict_.dict);
+      auto a = make_twa_graph(dict_->dict);
       auto namer = a->create_namer<formula>();
 
       typedef std::set<formula> set_type;
@@ -973,19 +1104,19 @@ namespace spot
           formulae_to_translate.erase(formulae_to_translate.begin());
 
           // Translate it
-          bdd res = translate_ratexp(now, dict_);
+          bdd res = translate_ratexp(now, *dict_);
 
           // Generate (deterministic) successors
-          bdd var_set = bdd_existcomp(bdd_support(res), dict_.var_set);
-          bdd all_props = bdd_existcomp(res, dict_.var_set);
+          bdd var_set = bdd_existcomp(bdd_support(res), dict_->var_set);
+          bdd all_props = bdd_existcomp(res, dict_->var_set);
           while (all_props != bddfalse)
             {
               bdd label = bdd_satoneset(all_props, var_set, bddtrue);
               all_props -= label;
 
               formula dest =
-                dict_.bdd_to_sere(bdd_appex(res, label, bddop_and,
-                                            dict_.var_set));
+                dict_->bdd_to_sere(bdd_appex(res, label, bddop_and,
+                                             dict_->var_set));
               f2a_t::const_iterator i = f2a_.find(dest);
               if (i != f2a_.end() && i->second.first == nullptr)
                 continue;
@@ -1677,6 +1808,18 @@ namespace spot
       if (i != ltl_bdd_.end())
         return i->second;
 
+      flagged_formula sf = ff;
+      if (store_)
+        {
+          sf.flags |= store_flags_;
+          i = store_->ltl_bdd.find(sf);
+          if (i != store_->ltl_bdd.end())
+            {
+              adopt(i->second.symbolic);
+              return ltl_bdd_.emplace(ff, i->second).first->second;
+            }
+        }
+
       translated t;
       if (f.is_boolean())
         {
@@ -1692,6 +1835,13 @@ namespace spot
           t.has_marked = v.has_marked();
         }
 
+      if (store_)
+        {
+          // The DFAs of the store may have introduced propositions
+          // we have not seen yet.
+          adopt(t.symbolic);
+          store_->ltl_bdd.emplace(sf, t);
+        }
       return ltl_bdd_.emplace(ff, t).first->second;
     }
 
@@ -1922,12 +2072,39 @@ namespace spot
     typedef std::vector<transition> dest_map;
   }
 
+  fm_fragment_cache::fm_fragment_cache(const bdd_dict_ptr& dict)
+    : dict_(dict), store_(new fm_fragment_store(dict))
+  {
+  }
+
+  fm_fragment_cache::~fm_fragment_cache()
+  {
+    delete store_;
+  }
+
+  unsigned
+  fm_fragment_cache::size() const
+  {
+    return store_->ltl_bdd.size();
+  }
+
+  void
+  fm_fragment_cache::clear()
+  {
+    store_->clear();
+  }
+
   twa_graph_ptr
   ltl_to_tgba_fm(formula f2, const bdd_dict_ptr& dict,
                  bool exprop, bool symb_merge, bool branching_postponement,
                  bool fair_loop_approx, const atomic_prop_set* unobs,
-                 tl_simplifier* simplifier, bool unambiguous)
+                 tl_simplifier* simplifier, bool unambiguous,
+                 fm_fragment_cache* cache)
   {
+    if (cache && cache->get_dict() != dict)
+      throw std::runtime_error
+        ("ltl_to_tgba_fm(): the cache should use the same bdd_dict");
+
     tl_simplifier* s = simplifier;
 
     // Simplify the formula, if requested.
@@ -1963,7 +2140,8 @@ namespace spot
     bool one_set_enough = (unambiguous
                             ? f2.is_syntactic_obligation()
                             : f2.is_syntactic_persistence());
-    translate_dict d(a, s, exprop, one_set_enough, unambiguous);
+    translate_dict d(a, s, exprop, one_set_enough, unambiguous,
+                     cache ? cache->store() : nullptr);
 
     // Compute the set of all promises that can possibly occur inside
     // the formula.  These are the right-hand sides of U or F
@@ -1,6 +1,6 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2010, 2011, 2012, 2013, 2014, 2015, 2017, 2019 Laboratoire de
-// Recherche et Développement de l'Epita (LRDE).
+// Copyright (C) 2010, 2011, 2012, 2013, 2014, 2015, 2017, 2019, 2020
+// Laboratoire de Recherche et Développement de l'Epita (LRDE).
 // Copyright (C) 2003, 2004, 2005, 2006 Laboratoire d'Informatique de
 // Paris 6 (LIP6), département Systèmes Répartis Coopératifs (SRC),
 // Université Pierre et Marie Curie.
@@ -29,6 +29,51 @@
 
 namespace spot
 {
+  class fm_fragment_store;
+
+  /// \ingroup twa_ltl
+  /// \brief Translations shared by several calls to ltl_to_tgba_fm().
+  ///
+  /// During one call, ltl_to_tgba_fm() caches the symbolic (BDD)
+  /// translation of each subformula it encounters, as well as the
+  /// DFAs it builds for SERE operands.  Passing the same
+  /// fm_fragment_cache to several calls allows these translations to
+  /// be reused across formulas that share subformulas.
+  ///
+  /// The cache keeps the BDD variables used by these translations
+  /// registered in its spot::bdd_dict, so all calls sharing a cache
+  /// must use the same dictionary.
+  class SPOT_API fm_fragment_cache final
+  {
+  public:
+    fm_fragment_cache(const bdd_dict_ptr& dict);
+    ~fm_fragment_cache();
+
+    fm_fragment_cache(const fm_fragment_cache&) = delete;
+    fm_fragment_cache& operator=(const fm_fragment_cache&) = delete;
+
+    const bdd_dict_ptr& get_dict() const
+    {
+      return dict_;
+    }
+
+    /// Number of cached subformula translations.
+    unsigned size() const;
+
+    /// Forget all translations, and release their BDD variables.
+    void clear();
+
+    /// Internal storage, only meant to be used by ltl_to_tgba_fm().
+    fm_fragment_store* store() const
+    {
+      return store_;
+    }
+
+  private:
+    bdd_dict_ptr dict_;
+    fm_fragment_store* store_;
+  };
+
   /// \ingroup twa_ltl
   /// \brief Build a spot::twa_graph_ptr from an LTL or PSL formula.
   ///
@@ -73,6 +118,11 @@ namespace spot
   /// \param unambiguous When true, unambigous TGBA will be produced
   /// using the trick described in \cite benedikt.13.tacas .
   ///
+  /// \param cache If non-null, translations of subformulas are looked
+  /// up in and added to this cache, so that they can be shared with
+  /// other calls.  The cache should use the same dictionary as \a
+  /// dict.
+  ///
   /// \return A spot::twa_graph that recognizes the language of \a f.
   SPOT_API twa_graph_ptr
   ltl_to_tgba_fm(formula f, const bdd_dict_ptr& dict,
@@ -81,5 +131,6 @@ namespace spot
                  bool fair_loop_approx = false,
                  const atomic_prop_set* unobs = nullptr,
                  tl_simplifier* simplifier = nullptr,
-                 bool unambiguous = false);
+                 bool unambiguous = false,
+                 fm_fragment_cache* cache = nullptr);
 }
@@ -509,7 +509,7 @@ namespace spot
         }
 
     private:
-      state_map<color> h;
+      state_open_map<color> h;
     };
 
     class bsh_magic_search_heap final
@@ -32,6 +32,7 @@
 #include <list>
 #include <vector>
 #include <sstream>
+#include <unordered_map>
 #include <spot/twaalgos/minimize.hh>
 #include <spot/misc/hash.hh>
 #include <spot/misc/bddlt.hh>
@@ -151,10 +152,263 @@ namespace spot
       return res;
     }
 
+    // Automata with fewer states are minimized by the signature-based
+    // loop of minimize_dfa(), whose output is the one expected by the
+    // test suite.  Larger automata use refine_partition().
+    constexpr unsigned refine_partition_threshold = 1024;
+    // Give up refine_partition() if the labels of the automaton have
+    // to be split into more letters than this.
+    constexpr unsigned refine_partition_max_letters = 4096;
+
+    // A partition of the integers 0..n-1 that can be refined by
+    // marking some elements and splitting the sets containing them.
+    // This is the data structure of Valmari and Lehtinen (STACS'08).
+    class refinable_partition
+    {
+    public:
+      unsigned sets;               // number of sets
+      std::vector<unsigned> elems; // elements, grouped by sets
+      std::vector<unsigned> loc;   // location of each element in elems
+      std::vector<unsigned> set_of;
+      std::vector<unsigned> first; // range of each set in elems
+      std::vector<unsigned> past;
+
+      refinable_partition(unsigned n)
+        : sets(n > 0), elems(n), loc(n), set_of(n, 0),
+          first(n + 1), past(n + 1), marked(n + 1, 0)
+      {
+        for (unsigned i = 0; i < n; ++i)
+          elems[i] = loc[i] = i;
+        first[0] = 0;
+        past[0] = n;
+      }
+
+      // Move e at the beginning of its set, after other marked
+      // elements.
+      void mark(unsigned e)
+      {
+        unsigned s = set_of[e];
+        unsigned i = loc[e];
+        unsigned j = first[s] + marked[s];
+        elems[i] = elems[j];
+        loc[elems[i]] = i;
+        elems[j] = e;
+        loc[e] = j;
+        if (!marked[s]++)
+          touched.push_back(s);
+      }
+
+      // Split each set with marked elements into its marked and
+      // unmarked parts.  The smallest part becomes a new set.
+      void split()
+      {
+        while (!touched.empty())
+          {
+            unsigned s = touched.back();
+            touched.pop_back();
+            unsigned j = first[s] + marked[s];
+            if (j == past[s])
+              {
+                marked[s] = 0;
+                continue;
+              }
+            if (marked[s] <= past[s] - j)
+              {
+                first[sets] = first[s];
+                past[sets] = first[s] = j;
+              }
+            else
+              {
+                past[sets] = past[s];
+                first[sets] = past[s] = j;
+              }
+            for (unsigned i = first[sets]; i < past[sets]; ++i)
+              set_of[elems[i]] = sets;
+            marked[s] = marked[sets++] = 0;
+          }
+      }
+
+    private:
+      std::vector<unsigned> marked; // number of marked elements per set
+      std::vector<unsigned> touched; // sets with marked elements
+    };
+
+    // Compute the coarsest partition of the states in FINAL and
+    // NON_FINAL that separates FINAL from NON_FINAL and such that
+    // equivalent states have equivalent successors for each letter.
+    // This is the same partition as the one computed by
+    // minimize_dfa(), but it is obtained in O(m log n) using the
+    // algorithm of Valmari and Lehtinen for partial DFAs, where m is
+    // the number of transitions after the labels have been split
+    // into disjoint letters.  The sets of the partition are ordered
+    // by their smallest state.  Return false if the labels need too
+    // many letters.
+    static bool
+    refine_partition(const const_twa_graph_ptr& det_a,
+                     const hash_set* final, const hash_set* non_final,
+                     std::list<hash_set*>& res)
+    {
+      unsigned ns = det_a->num_states();
+      // Number the states of FINAL and NON_FINAL.  Edges leading to
+      // other states are ignored.
+      std::vector<unsigned> num(ns, -1U);
+      std::vector<unsigned> state_of;
+      state_of.reserve(final->size() + non_final->size());
+      for (unsigned s = 0; s < ns; ++s)
+        if (final->find(s) != final->end()
+            || non_final->find(s) != non_final->end())
+          {
+            num[s] = state_of.size();
+            state_of.push_back(s);
+          }
+      unsigned n = state_of.size();
+
+      // Split the labels into disjoint letters.
+      std::unordered_map<int, unsigned> label_num;
+      std::vector<bdd> labels;
+      std::vector<bdd> letters;
+      letters.emplace_back(bddtrue);
+      for (unsigned s: state_of)
+        for (auto& e: det_a->out(s))
+          if (num[e.dst] != -1U
+              && label_num.emplace(e.cond.id(), labels.size()).second)
+            {
+              labels.emplace_back(e.cond);
+              unsigned nl = letters.size();
+              for (unsigned l = 0; l < nl; ++l)
+                {
+                  bdd in = letters[l] & e.cond;
+                  if (in == bddfalse || in == letters[l])
+                    continue;
+                  letters.emplace_back(letters[l] - e.cond);
+                  letters[l] = in;
+                }
+              if (letters.size() > refine_partition_max_letters)
+                return false;
+            }
+      std::vector<std::vector<unsigned>> letters_of(labels.size());
+      for (unsigned i = 0; i < labels.size(); ++i)
+        for (unsigned l = 0; l < letters.size(); ++l)
+          if (bdd_implies(letters[l], labels[i]))
+            letters_of[i].push_back(l);
+
+      // The transitions, sorted by letters.
+      std::vector<unsigned> tail;
+      std::vector<unsigned> head;
+      std::vector<unsigned> count(letters.size() + 1, 0);
+      for (unsigned s: state_of)
+        for (auto& e: det_a->out(s))
+          if (num[e.dst] != -1U)
+            for (unsigned l: letters_of[label_num[e.cond.id()]])
+              ++count[l + 1];
+      for (unsigned l = 1; l <= letters.size(); ++l)
+        count[l] += count[l - 1];
+      unsigned m = count.back();
+      tail.resize(m);
+      head.resize(m);
+      {
+        std::vector<unsigned> pos(count.begin(), count.end() - 1);
+        for (unsigned s: state_of)
+          for (auto& e: det_a->out(s))
+            if (num[e.dst] != -1U)
+              for (unsigned l: letters_of[label_num[e.cond.id()]])
+                {
+                  unsigned t = pos[l]++;
+                  tail[t] = num[s];
+                  head[t] = num[e.dst];
+                }
+      }
+
+      // The incoming transitions of each state.
+      std::vector<unsigned> in_first(n + 1, 0);
+      std::vector<unsigned> in(m);
+      for (unsigned t = 0; t < m; ++t)
+        ++in_first[head[t] + 1];
+      for (unsigned i = 1; i <= n; ++i)
+        in_first[i] += in_first[i - 1];
+      {
+        std::vector<unsigned> pos(in_first.begin(), in_first.end() - 1);
+        for (unsigned t = 0; t < m; ++t)
+          in[pos[head[t]]++] = t;
+      }
+
+      refinable_partition blocks(n);
+      for (unsigned s: *final)
+        if (num[s] != -1U)
+          blocks.mark(num[s]);
+      blocks.split();
+
+      // The partition of transitions starts with one set per letter.
+      refinable_partition cords(m);
+      if (m > 0)
+        {
+          cords.sets = 0;
+          for (unsigned l = 0; l < letters.size(); ++l)
+            if (count[l] < count[l + 1])
+              {
+                cords.first[cords.sets] = count[l];
+                cords.past[cords.sets] = count[l + 1];
+                for (unsigned t = count[l]; t < count[l + 1]; ++t)
+                  cords.set_of[t] = cords.sets;
+                ++cords.sets;
+              }
+        }
+
+      // Split the blocks of states by the tails of each set of
+      // transitions, and the sets of transitions by the heads of each
+      // new block of states.  Block 0 does not need to be used as a
+      // splitter.
+      unsigned b = 1;
+      for (unsigned c = 0; c < cords.sets; ++c)
+        {
+          for (unsigned i = cords.first[c]; i < cords.past[c]; ++i)
+            blocks.mark(tail[cords.elems[i]]);
+          blocks.split();
+          for (; b < blocks.sets; ++b)
+            {
+              for (unsigned i = blocks.first[b]; i < blocks.past[b]; ++i)
+                {
+                  unsigned s = blocks.elems[i];
+                  for (unsigned j = in_first[s]; j < in_first[s + 1]; ++j)
+                    cords.mark(in[j]);
+                }
+              cords.split();
+            }
+        }
+
+      std::vector<hash_set*> sets(blocks.sets, nullptr);
+      for (unsigned i = 0; i < n; ++i)
+        {
+          hash_set*& h = sets[blocks.set_of[i]];
+          if (!h)
+            {
+              h = new hash_set;
+              res.emplace_back(h);
+            }
+          h->emplace_hint(h->end(), state_of[i]);
+        }
+      return true;
+    }
+
     static twa_graph_ptr minimize_dfa(const const_twa_graph_ptr& det_a,
                                       hash_set* final, hash_set* non_final)
     {
       typedef std::list<hash_set*> partition_t;
+
+      if (det_a->num_states() > refine_partition_threshold)
+        {
+          partition_t sets;
+          if (refine_partition(det_a, final, non_final, sets))
+            {
+              auto res = build_result(det_a, sets, final);
+              for (hash_set* hs: sets)
+                delete hs;
+              delete final;
+              delete non_final;
+              return res;
+            }
+        }
+
       partition_t cur_run;
       partition_t next_run;
 
@@ -55,6 +55,11 @@ namespace spot
     /// The acceptance set of the transition traversed to reach \a s
     /// (false for the first one).
     acc_cond::mark_t acc;
+    /// When \a it is nullptr, the successors of \a s that remain to
+    /// be visited are the elements [pos, end) of a buffer filled by
+    /// twa::succ_batch().
+    unsigned pos = 0;
+    unsigned end = 0;
   };
 
   typedef std::list<stack_item> stack_type;
@@ -49,23 +49,42 @@ namespace spot
       unsigned ns = in->size();
       for (unsigned pos = 0; pos < ns; ++pos)
         if (in->get(pos))
-          ps.insert(pos);
+          ps.emplace_hint(ps.end(), pos);
       return ps;
     }
 
+    // Hashing large bit vectors is costly, so store the hash value
+    // of each macro-state in its key.  (libstdc++ would not store
+    // it in the nodes of an unordered_map for a noexcept hash.)
+    struct bv_key
+    {
+      const bitvect* bv;
+      size_t hash;
+
+      explicit bv_key(const bitvect* bv)
+        : bv(bv), hash(bv->hash())
+      {
+      }
+
+      bv_key(const bitvect* bv, size_t hash)
+        : bv(bv), hash(hash)
+      {
+      }
+    };
+
     struct bv_hash
     {
-      size_t operator()(const bitvect* bv) const noexcept
+      size_t operator()(const bv_key& k) const noexcept
       {
-        return bv->hash();
+        return k.hash;
       }
     };
 
     struct bv_equal
     {
-      bool operator()(const bitvect* bvl, const bitvect* bvr) const
+      bool operator()(const bv_key& l, const bv_key& r) const
       {
-        return *bvl == *bvr;
+        return l.hash == r.hash && *l.bv == *r.bv;
       }
     };
   }
@@ -108,98 +127,53 @@ namespace spot
     size_t nc = num2bdd.size();        // number of conditions
     assert(nc == (1UL << nap));
 
-    // Conceptually, we represent the automaton as an array 'bv' of
-    // ns*nc bit vectors of size 'ns'.  Each original state is
-    // represented by 'nc' consecutive bitvectors representing the
-    // possible destinations for each condition.
-    //
-    //  src  cond
-    //  0   !a&!b   [...bit vector of size ns...]
-    //      !a&b    [...bit vector of size ns...]
-    //       a&!b   [...bit vector of size ns...]
-    //       a&b    [...bit vector of size ns...]
-    //  1   !a&!b   [...bit vector of size ns...]
-    //      !a&b    [...bit vector of size ns...]
-    //       a&!b   [...bit vector of size ns...]
-    //       a&b    [...bit vector of size ns...]
-    //  2   !a&!b   [...bit vector of size ns...]
-    //      !a&b    [...bit vector of size ns...]
-    //       a&!b   [...bit vector of size ns...]
-    //       a&b    [...bit vector of size ns...]
-    //  ...
+    // For each edge of the automaton, precompute the indexes of the
+    // letters (i.e., the conjunctions of all atomic propositions) it
+    // is labeled by.  These lists are computed once per label using
+    // bdd_satoneset() and stored contiguously in 'letters'; the
+    // letters of edge number e are those in the range
+    // [edge_letters[e].first, edge_letters[e].second).
     //
-    // Since there are nc possible "cond" value, and ns sources, the
-    // ns*nc bitvectors of ns bits each can take a lot of space.  In
-    // issue #302, we had the case of an automaton with ns=8777
-    // states, and 8 atomic propositions (nc=256): this large array
-    // would require 2.3GB, causing out-of-memory error on small
-    // systems.
-    //
-    // To work around this, we reduce the number of states we store in
-    // this array to reduced_ns, which we currently limit to 512
-    // (chosen arbitrarily), and use it as a least-recently-used
-    // cache.  A separate vector of size ns, contains pointers
-    // (i.e. iterators) to a list cell that gives an index in this
-    // cache.  The purpose of the list is to maintain the
-    // least-recently-used order.
-    typedef std::list<std::pair<unsigned, unsigned>>::const_iterator iter;
-    std::list<std::pair<unsigned, unsigned>> lru; // list of (idx in bv, state#)
-    std::vector<iter> iters(ns, lru.end());
-    const unsigned reduced_ns = std::min(512U, ns);
-    auto bv =
-      std::unique_ptr<bitvect_array>(make_bitvect_array(ns, reduced_ns * nc));
-
-    // Get the index of src in bv, filling bv in an LRU-fashion if needed.
-    auto index = [&](unsigned src) {
-      iter i = iters[src];
-      if (i != lru.end())
-        {
-          // bv has already been filled for this state.  Just move it
-          // to the front of the LRU list.
-          lru.splice(lru.begin(), lru, i);
-          return i->first;
-        }
-
-      unsigned idx = lru.size();
-      bool reused = false;
-      if (idx < reduced_ns)
-        {
-          lru.emplace_front(idx, src);
-        }
-      else
-        {
-          unsigned state;
-          std::tie(idx, state) = lru.back();
-          iters[state] = lru.end();
-          lru.pop_back();
-          lru.emplace_front(idx, src);
-          reused = true;
-        }
-      iters[src] = lru.begin();
-
-      size_t base = idx * nc;
-      if (reused)
-        for (unsigned i = 0; i < nc; ++i)
-          bv->at(base + i).clear_all();
-      for (auto& t: aut->out(src))
+    // An earlier implementation stored, for each state and letter,
+    // a bit vector of size ns of the possible destinations.  Those
+    // ns*nc*ns bits could take a lot of space (in issue #302, we had
+    // the case of an automaton with ns=8777 states and 8 atomic
+    // propositions, requiring 2.3GB), so they were kept in an LRU
+    // cache of 512 states, rebuilt each time a state was evicted.
+    // Additionally, computing the successors of a macro-state
+    // required to OR nc full bit vectors per state, even when that
+    // state had only a couple of outgoing edges.  The per-edge
+    // ranges need memory proportional to the number of edges and
+    // distinct labels, and the successors of a macro-state are
+    // computed in time proportional to the number of letters of its
+    // outgoing edges.
+    typedef std::pair<unsigned, unsigned> range_t;
+    std::vector<unsigned> letters;
+    std::vector<range_t> edge_letters(aut->edge_vector().size());
+    {
+      std::unordered_map<int, range_t> known; // label -> letters
+      for (auto& t: aut->edges())
         {
-          bdd all = t.cond;
-          while (all != bddfalse)
+          auto p = known.emplace(t.cond.id(), range_t{});
+          if (p.second)
             {
-              bdd one = bdd_satoneset(all, allap, bddfalse);
-              all -= one;
-              unsigned num = bdd2num[one];
-              bv->at(base + num).set(t.dst);
+              p.first->second.first = letters.size();
+              bdd all = t.cond;
+              while (all != bddfalse)
+                {
+                  bdd one = bdd_satoneset(all, allap, bddfalse);
+                  all -= one;
+                  letters.push_back(bdd2num[one]);
+                }
+              p.first->second.second = letters.size();
             }
+          edge_letters[aut->edge_number(t)] = p.first->second;
         }
-
-      assert(idx == lru.begin()->first);
-      return idx;
-    };
+    }
 
     typedef power_map::power_state power_state;
 
-    typedef std::unordered_map<bitvect*, int, bv_hash, bv_equal> power_set;
+    typedef std::unordered_map<bv_key, int, bv_hash, bv_equal> power_set;
     power_set seen;
 
     std::vector<const bitvect*> toclean;
@@ -214,7 +188,7 @@ namespace spot
       power_state ps{init_num};
       unsigned num = res->new_state();
       res->set_init_state(num);
-      seen[bvi] = num;
+      seen.emplace(bv_key(bvi), num);
       assert(pm.map_.size() == num);
       pm.map_.emplace_back(std::move(ps));
       toclean.emplace_back(bvi);
@@ -222,24 +196,42 @@ namespace spot
 
     // outgoing map
     auto om = std::unique_ptr<bitvect_array>(make_bitvect_array(ns, nc));
+    // Letters whose row of om is not clear.
+    std::vector<unsigned> touched;
+    std::vector<bool> is_touched(nc, false);
 
     for (unsigned src_num = 0; src_num < res->num_states(); ++src_num)
       {
-        om->clear_all();
+        for (unsigned c: touched)
+          {
+            om->at(c).clear_all();
+            is_touched[c] = false;
+          }
+        touched.clear();
 
         const power_state& src = pm.states_of(src_num);
         for (auto s: src)
-          {
-            size_t base = index(s) * nc;
-            for (unsigned c = 0; c < nc; ++c)
-              om->at(c) |= bv->at(base + c);
-          }
+          for (auto& t: aut->out(s))
+            {
+              range_t r = edge_letters[aut->edge_number(t)];
+              for (unsigned l = r.first; l < r.second; ++l)
+                {
+                  unsigned c = letters[l];
+                  om->at(c).set(t.dst);
+                  if (!is_touched[c])
+                    {
+                      is_touched[c] = true;
+                      touched.push_back(c);
+                    }
+                }
+            }
         for (unsigned c = 0; c < nc; ++c)
           {
-            auto dst = &om->at(c);
-            if (dst->is_fully_clear())
+            if (!is_touched[c])
               continue;
-            auto i = seen.find(dst);
+            auto dst = &om->at(c);
+            bv_key key(dst);
+            auto i = seen.find(key);
             unsigned dst_num;
             if (i != seen.end())
               {
@@ -249,7 +241,7 @@ namespace spot
               {
                 dst_num = res->new_state();
                 auto dst2 = dst->clone();
-                seen[dst2] = dst_num;
+                seen.emplace(bv_key(dst2, key.hash), dst_num);
                 toclean.emplace_back(dst2);
                 auto ps = bv_to_ps(dst);
                 assert(pm.map_.size() == dst_num);
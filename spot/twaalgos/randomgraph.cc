@@ -26,9 +26,8 @@
 #include <spot/misc/random.hh>
 #include <spot/misc/bddlt.hh>
 #include <sstream>
-#include <list>
-#include <set>
-#include <iterator>
+#include <functional>
+#include <queue>
 #include <vector>
 
 namespace spot
@@ -37,7 +36,8 @@ namespace spot
   namespace
   {
     static unsigned
-    random_deterministic_labels_rec(std::vector<bdd>& labels, int *props,
+    random_deterministic_labels_rec(random_generator& gen,
+                                    std::vector<bdd>& labels, int *props,
                                     int props_n, bdd current, unsigned n)
     {
       if (n > 1 && props_n >= 1)
@@ -48,17 +48,17 @@ namespace spot
 
           // There are m labels generated from "current & ap"
           // and n - m labels generated from "current & !ap"
-          unsigned m = rrand(1, n - 1);
+          unsigned m = gen.rrand(1, n - 1);
           if (2 * m < n)
             {
               m = n - m;
               ap = !ap;
             }
 
-          unsigned res = random_deterministic_labels_rec(labels, props,
+          unsigned res = random_deterministic_labels_rec(gen, labels, props,
                                                          props_n,
                                                          current & ap, m);
-          res += random_deterministic_labels_rec(labels, props, props_n,
+          res += random_deterministic_labels_rec(gen, labels, props, props_n,
                                                  current & !ap, n - res);
           return res;
         }
@@ -70,32 +70,33 @@ namespace spot
     }
 
     static std::vector<bdd>
-    random_deterministic_labels(int *props, int props_n, unsigned n)
+    random_deterministic_labels(random_generator& gen,
+                                int *props, int props_n, unsigned n)
     {
       std::vector<bdd> bddvec;
-      random_deterministic_labels_rec(bddvec, props, props_n, bddtrue, n);
+      random_deterministic_labels_rec(gen, bddvec, props, props_n, bddtrue, n);
       return bddvec;
     }
 
     static acc_cond::mark_t
-    random_acc(unsigned n_accs, float a)
+    random_acc(random_generator& gen, unsigned n_accs, float a)
     {
       acc_cond::mark_t m = {};
       for (unsigned i = 0U; i < n_accs; ++i)
-        if (drand() < a)
+        if (gen.drand() < a)
           m.set(i);
       return m;
     }
 
     static acc_cond::mark_t
-    random_acc1(unsigned n_accs)
+    random_acc1(random_generator& gen, unsigned n_accs)
     {
-      auto u = static_cast<unsigned>(mrand(static_cast<int>(n_accs)));
+      auto u = static_cast<unsigned>(gen.mrand(static_cast<int>(n_accs)));
       return acc_cond::mark_t({u});
     }
 
     bdd
-    random_labels(int* props, int props_n, float t)
+    random_labels(random_generator& gen, int* props, int props_n, float t)
     {
       int val = 0;
       int size = 0;
@@ -110,7 +111,7 @@ namespace spot
               size = 0;
             }
           val <<= 1;
-          val |= (drand() < t);
+          val |= (gen.drand() < t);
           ++size;
           --props_n;
         }
@@ -119,6 +120,74 @@ namespace spot
 
       return p;
     }
+
+    // The set of states that have not been reached yet, among states
+    // 1 to n-1.  A Fenwick tree counts the unreached states in each
+    // range, so that the i-th smallest unreached state can be found
+    // (and removed) in logarithmic time.
+    class unreached_states
+    {
+    public:
+      explicit unreached_states(unsigned n)
+        : tree_(n, 0), unreached_(n, true), size_(n - 1), top_(1)
+      {
+        unreached_[0] = false;
+        // Build the tree in linear time.  Node i counts the
+        // unreached states in i-lowbit(i)+1..i, where lowbit(i) is
+        // the lowest bit set in i.  State 0 is always reached.
+        for (unsigned i = 1; i < n; ++i)
+          {
+            tree_[i] += 1;
+            unsigned j = i + (i & -i);
+            if (j < n)
+              tree_[j] += tree_[i];
+          }
+        while (2 * top_ < n)
+          top_ *= 2;
+      }
+
+      bool empty() const
+      {
+        return size_ == 0;
+      }
+
+      unsigned size() const
+      {
+        return size_;
+      }
+
+      bool contains(unsigned s) const
+      {
+        return unreached_[s];
+      }
+
+      // The state of rank i (starting at 0) in increasing order.
+      unsigned nth(unsigned i) const
+      {
+        unsigned pos = 0;
+        for (unsigned step = top_; step; step /= 2)
+          if (pos + step < tree_.size() && tree_[pos + step] <= i)
+            {
+              pos += step;
+              i -= tree_[pos];
+            }
+        return pos + 1;
+      }
+
+      void erase(unsigned s)
+      {
+        unreached_[s] = false;
+        --size_;
+        for (unsigned i = s; i < tree_.size(); i += i & -i)
+          --tree_[i];
+      }
+
+    private:
+      std::vector<unsigned> tree_;
+      std::vector<bool> unreached_;
+      unsigned size_;
+      unsigned top_;
+    };
   }
 
   twa_graph_ptr
@@ -126,6 +195,16 @@ namespace spot
                const atomic_prop_set* ap, const bdd_dict_ptr& dict,
                unsigned n_accs, float a, float t,
                bool deterministic, bool state_acc, bool colored)
+  {
+    return random_graph(default_random_generator(), n, d, ap, dict,
+                        n_accs, a, t, deterministic, state_acc, colored);
+  }
+
+  twa_graph_ptr
+  random_graph(random_generator& gen, int n, float d,
+               const atomic_prop_set* ap, const bdd_dict_ptr& dict,
+               unsigned n_accs, float a, float t,
+               bool deterministic, bool state_acc, bool colored)
   {
     if (n <= 0)
       throw std::invalid_argument("random_graph() requires n>0 states");
@@ -144,23 +223,19 @@ namespace spot
 
     res->set_generalized_buchi(n_accs);
 
-    // Using std::unordered_set instead of std::set for these sets is 3
-    // times slower (tested on a 50000 nodes example).
-    typedef std::set<int> node_set;
-    node_set nodes_to_process;
-    node_set unreachable_nodes;
+    // The reached states are processed in increasing order.
+    std::priority_queue<unsigned, std::vector<unsigned>,
+                        std::greater<unsigned>> nodes_to_process;
+    unreached_states unreachable_nodes(n);
 
     res->new_states(n);
 
     std::vector<unsigned> state_randomizer(n);
     state_randomizer[0] = 0;
-    nodes_to_process.insert(0);
+    nodes_to_process.push(0);
 
     for (int i = 1; i < n; ++i)
-      {
-        state_randomizer[i] = i;
-        unreachable_nodes.insert(i);
-      }
+      state_randomizer[i] = i;
 
     // We want to connect each node to a number of successors between
     // 1 and n.  If the probability to connect to each successor is d,
@@ -169,12 +244,12 @@ namespace spot
 
     while (!nodes_to_process.empty())
       {
-        auto src = *nodes_to_process.begin();
-        nodes_to_process.erase(nodes_to_process.begin());
+        unsigned src = nodes_to_process.top();
+        nodes_to_process.pop();
 
         // Choose a random number of successors (at least one), using
         // a binomial distribution.
-        unsigned nsucc = 1 + bin.rand();
+        unsigned nsucc = 1 + bin.rand(gen);
 
         bool saw_unreachable = false;
 
@@ -182,7 +257,7 @@ namespace spot
         std::vector<bdd> labels;
         if (deterministic)
           {
-            labels = random_deterministic_labels(props, props_n, nsucc);
+            labels = random_deterministic_labels(gen, props, props_n, nsucc);
 
             // if nsucc > 2^props_n, we cannot produce nsucc deterministic
             // edges so we set it to labels.size()
@@ -190,18 +265,20 @@ namespace spot
           }
         else
           for (unsigned i = 0; i < nsucc; ++i)
-            labels.emplace_back(random_labels(props, props_n, t));
+            labels.emplace_back(random_labels(gen, props, props_n, t));
 
         int possibilities = n;
         unsigned dst;
         acc_cond::mark_t m = {};
         if (state_acc)
-          m = colored ? random_acc1(n_accs) : random_acc(n_accs, a);
+          m = (colored ? random_acc1(gen, n_accs)
+               : random_acc(gen, n_accs, a));
 
         for (auto& l: labels)
           {
             if (!state_acc)
-              m = colored ? random_acc1(n_accs) : random_acc(n_accs, a);
+              m = (colored ? random_acc1(gen, n_accs)
+                   : random_acc(gen, n_accs, a));
 
             // No connection to unreachable successors so far.  This
             // is our last chance, so force it now.
@@ -210,19 +287,18 @@ namespace spot
                 && !saw_unreachable)
               {
                 // Pick a random unreachable node.
-                int index = mrand(unreachable_nodes.size());
-                node_set::const_iterator i = unreachable_nodes.begin();
-                std::advance(i, index);
+                int index = gen.mrand(unreachable_nodes.size());
+                unsigned i = unreachable_nodes.nth(index);
 
                 // Link it from src.
-                res->new_edge(src, *i, l, m);
-                nodes_to_process.insert(*i);
-                unreachable_nodes.erase(*i);
+                res->new_edge(src, i, l, m);
+                nodes_to_process.push(i);
+                unreachable_nodes.erase(i);
                 break;
               }
 
             // Pick the index of a random node.
-            int index = mrand(possibilities--);
+            int index = gen.mrand(possibilities--);
 
             // Permute it with state_randomizer[possibilities], so
             // we cannot pick it again.
@@ -231,11 +307,10 @@ namespace spot
             state_randomizer[possibilities] = dst;
 
             res->new_edge(src, dst, l, m);
-            auto j = unreachable_nodes.find(dst);
-            if (j != unreachable_nodes.end())
+            if (unreachable_nodes.contains(dst))
               {
-                nodes_to_process.insert(dst);
-                unreachable_nodes.erase(j);
+                nodes_to_process.push(dst);
+                unreachable_nodes.erase(dst);
                 saw_unreachable = true;
               }
           }
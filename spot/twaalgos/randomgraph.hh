@@ -26,6 +26,7 @@
 #include <spot/tl/defaultenv.hh>
 #include <spot/twa/bdddict.hh>
 #include <spot/twa/acc.hh>
+#include <spot/misc/random.hh>
 
 namespace spot
 {
@@ -75,6 +76,21 @@ namespace spot
                bool deterministic = false, bool state_acc = false,
                bool colored = false);
 
+  /// \ingroup twa_misc
+  /// \brief Construct a twa randomly, drawing from \a gen.
+  ///
+  /// This is the same as the above function, except that random
+  /// numbers are drawn from \a gen instead of the global generator
+  /// used by spot::srand() and friends.  The above function is
+  /// equivalent to calling this one with
+  /// spot::default_random_generator().
+  SPOT_API twa_graph_ptr
+  random_graph(random_generator& gen, int n, float d,
+               const atomic_prop_set* ap, const bdd_dict_ptr& dict,
+               unsigned n_accs = 0, float a = 0.1, float t = 0.5,
+               bool deterministic = false, bool state_acc = false,
+               bool colored = false);
+
   /// Build a random acceptance where each acceptance sets is used once.
   SPOT_API acc_cond::acc_code random_acceptance(unsigned n_accs);
 }
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2015-2019 Laboratoire de Recherche et Développement
+// Copyright (C) 2015-2020 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -24,7 +24,7 @@
 #include <spot/twaalgos/cleanacc.hh>
 #include <spot/twaalgos/totgba.hh>
 #include <spot/twaalgos/isdet.hh>
-#include <spot/twaalgos/mask.hh>
+#include <spot/twaalgos/genem.hh>
 #include <spot/twaalgos/alternation.hh>
 
 // #define TRACE
@@ -50,9 +50,6 @@ namespace spot
     using strategy =
         std::function<twa_graph_ptr(const const_twa_graph_ptr& aut)>;
 
-    twa_graph_ptr
-    remove_fin_impl(const const_twa_graph_ptr&, const strategy_t);
-
     using EdgeMask = std::vector<bool>;
 
     template< typename Edges, typename Apply >
@@ -146,24 +143,19 @@ namespace spot
       // more edges.
       if (!scc_infs_alone)
         {
-          // Check whether the SCC is accepting.  We do that by simply
-          // converting that SCC into a TGBA and running our emptiness
-          // check.  This is not a really smart implementation and
-          // could be improved.
+          // Check whether the SCC is accepting, by running the
+          // generic emptiness check on the part of the automaton
+          // induced by the states of the SCC.  This filters the
+          // automaton in place instead of copying the SCC.
           auto& states = si.states_of(scc);
           std::vector<bool> keep_states(aut->num_states(), false);
           for (auto s: states)
             keep_states[s] = true;
-          auto sccaut = mask_keep_accessible_states(aut,
-                                                    keep_states,
-                                                    states.front());
-          // Prevent recurring into this function by skipping the
-          // Rabin strategy
-          auto skip = strategy_t::rabin;
-          // If SCCAUT is empty, the SCC is BA-type (and none of its
-          // states are final).  If SCCAUT is nonempty, the SCC is not
+          scc_and_mark_filter filt(aut, keep_states, states.front());
+          // If this part is empty, the SCC is BA-type (and none of its
+          // states are final).  If it is nonempty, the SCC is not
           // BA type
-          return remove_fin_impl(sccaut, skip)->is_empty();
+          return generic_emptiness_check(filt);
         }
 
       // Remaining infs corresponds to I₁s that have been seen without seeing
@@ -349,8 +341,7 @@ namespace spot
         }
       res->prop_complete(complete);
       res->prop_universal(deterministic);
-      res->purge_dead_states();
-      res->merge_edges();
+      res->purge_dead_states_and_merge_edges();
       if (!aut_pairs.infs())
         make_state_acc(res);
       return res;
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2014-2019 Laboratoire de Recherche et Développement
+// Copyright (C) 2014-2020 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -19,6 +19,7 @@
 
 #include "config.h"
 #include <spot/twaalgos/sccinfo.hh>
+#include <spot/misc/parallel.hh>
 #include <stack>
 #include <algorithm>
 #include <queue>
@@ -78,7 +79,17 @@ namespace spot
   scc_info::scc_info(const scc_and_mark_filter& filt, scc_info_options options)
     : scc_info(filt.get_aut(), filt.start_state(),
                filt.get_filter(),
-               const_cast<scc_and_mark_filter*>(&filt), options)
+               const_cast<scc_and_mark_filter*>(&filt), options,
+               nullptr, &filt.get_acceptance())
+  {
+  }
+
+  scc_info::scc_info(const scc_and_mark_filter& filt, scc_info_options options,
+                     scc_info_workspace& ws)
+    : scc_info(filt.get_aut(), filt.start_state(),
+               filt.get_filter(),
+               const_cast<scc_and_mark_filter*>(&filt), options, &ws,
+               &filt.get_acceptance())
   {
   }
 
@@ -86,10 +97,12 @@ namespace spot
                      unsigned initial_state,
                      edge_filter filter,
                      void* filter_data,
-                     scc_info_options options)
+                     scc_info_options options,
+                     scc_info_workspace* ws,
+                     const acc_cond* acc)
     : aut_(aut), initial_state_(initial_state),
       filter_(filter), filter_data_(filter_data),
-      options_(options)
+      options_(options), acc_(acc ? acc : &aut->acc())
   {
     unsigned n = aut->num_states();
 
@@ -97,16 +110,44 @@ namespace spot
       throw std::runtime_error
         ("scc_info: supplied initial state does not exist");
 
-    sccof_.resize(n, -1U);
-
     if (!!(options & scc_info_options::TRACK_STATES_IF_FIN_USED)
-        && aut->acc().uses_fin_acceptance())
+        && acc_->uses_fin_acceptance())
       options_ = options = options | scc_info_options::TRACK_STATES;
 
-    std::vector<unsigned> live;
-    live.reserve(n);
+    // The vectors indexed by states are either allocated here, or
+    // borrowed from the workspace.
+    std::vector<unsigned> own_live;
+    std::vector<int> own_h;
+    std::vector<bool> own_init_seen;
+    if (ws)
+      {
+        ws_.ws = ws;
+        if (!ws->sccof_pool_.empty())
+          {
+            sccof_ = std::move(ws->sccof_pool_.back());
+            ws->sccof_pool_.pop_back();
+            visited_ = std::move(ws->visited_pool_.back());
+            ws->visited_pool_.pop_back();
+          }
+        if (sccof_.size() < n)
+          sccof_.resize(n, -1U);
+        if (ws->h_.size() < n)
+          {
+            ws->h_.resize(n, 0);
+            ws->init_seen_.resize(n, false);
+          }
+      }
+    else
+      {
+        sccof_.resize(n, -1U);
+        own_live.reserve(n);
+        own_h.resize(n, 0);
+        own_init_seen.resize(n, false);
+      }
+
+    std::vector<unsigned>& live = ws ? ws->live_ : own_live;
     std::deque<scc> root_;        // Stack of SCC roots.
-    std::vector<int> h_(n, 0);
+    std::vector<int>& h_ = ws ? ws->h_ : own_h;
     // Map of visited states.  Values > 0 designate maximal SCC.
     // Values < 0 number states that are part of incomplete SCCs being
     // completed.  0 denotes non-visited states.
@@ -126,7 +167,7 @@ namespace spot
     auto& gr = aut->get_graph();
 
     std::deque<unsigned> init_states;
-    std::vector<bool> init_seen(n, false);
+    std::vector<bool>& init_seen = ws ? ws->init_seen_ : own_init_seen;
     auto push_init = [&](unsigned s)
       {
         if (h_[s] != 0 || init_seen[s])
@@ -134,6 +175,19 @@ namespace spot
         init_seen[s] = true;
         init_states.push_back(s);
       };
+    // Give the workspace back in the state we found it.
+    auto reset_workspace = [&]()
+      {
+        if (!ws)
+          return;
+        for (unsigned s: visited_)
+          {
+            h_[s] = 0;
+            init_seen[s] = false;
+          }
+        for (unsigned s: init_states)
+          init_seen[s] = false;
+      };
 
     bool track_states = !!(options & scc_info_options::TRACK_STATES);
     bool track_succs = !!(options & scc_info_options::TRACK_SUCCS);
@@ -199,7 +253,7 @@ namespace spot
             if (accept)
               one_acc_scc_ = num;
             bool reject = triv ||
-              aut->acc().maybe_accepting(acc, common).is_false();
+              acc_->maybe_accepting(acc, common).is_false();
             node_.back().rejecting_ = reject;
             root_.pop_back();
           }
@@ -221,6 +275,8 @@ namespace spot
           continue;
         assert(spi == 0);
         h_[init] = --num_;
+        if (ws)
+          visited_.push_back(init);
         root_.emplace_back(num_, acc_cond::mark_t({}));
         todo_.emplace(stack_item{init, gr.state_storage(init).succ, 0});
         live.emplace_back(init);
@@ -297,6 +353,8 @@ namespace spot
                 // Yes.  Number it, stack it, and register its successors
                 // for later processing.
                 h_[dest] = --num_;
+                if (ws)
+                  visited_.push_back(dest);
                 root_.emplace_back(num_, acc);
                 todo_.emplace(stack_item{dest, gr.state_storage(dest).succ, 0});
                 live.emplace_back(dest);
@@ -324,7 +382,7 @@ namespace spot
             bool is_accepting = false;
             // If this is a self-loop, check its acceptance alone.
             if (dest == e.src)
-              is_accepting = aut->acc().accepting(acc);
+              is_accepting = acc_->accepting(acc);
 
             acc_cond::mark_t common = acc;
             assert(!root_.empty());
@@ -348,7 +406,7 @@ namespace spot
             root_.back().acc |= acc;
             root_.back().common &= common;
             root_.back().accepting |= is_accepting
-              || aut->acc().accepting(root_.back().acc);
+              || acc_->accepting(root_.back().acc);
             // This SCC is no longer trivial.
             root_.back().trivial = false;
 
@@ -361,14 +419,28 @@ namespace spot
                     todo_.pop();
                     backtrack(curr);
                   }
+                reset_workspace();
                 return;
               }
           }
       }
+    reset_workspace();
     if (track_succs && !(options & scc_info_options::STOP_ON_ACC))
       determine_usefulness();
   }
 
+  scc_info::~scc_info()
+  {
+    scc_info_workspace* ws = ws_.ws;
+    if (!ws)
+      return;
+    for (unsigned s: visited_)
+      sccof_[s] = -1U;
+    visited_.clear();
+    ws->sccof_pool_.emplace_back(std::move(sccof_));
+    ws->visited_pool_.emplace_back(std::move(visited_));
+  }
+
   void scc_info::determine_usefulness()
   {
     // An SCC is useful if it is not rejecting or it has a successor
@@ -448,33 +520,58 @@ namespace spot
     return generic_emptiness_check_for_scc(*this, n);
   }
 
-  void scc_info::determine_unknown_acceptance()
+  void scc_info::determine_unknown_acceptance(parallel_policy ppolicy)
   {
-    unsigned s = scc_count();
+    unsigned n = scc_count();
     bool changed = false;
-    // iterate over SCCs in topological order
-    do
-      {
-        --s;
-        if (!is_rejecting_scc(s) && !is_accepting_scc(s))
-          {
-            if (SPOT_UNLIKELY(!aut_->is_existential()))
-              throw std::runtime_error(
-                  "scc_info::determine_unknown_acceptance() "
-                  "does not support alternating automata");
-            auto& node = node_[s];
-            if (check_scc_emptiness(s))
-              node.rejecting_ = true;
-            else
-              node.accepting_ = true;
-            changed = true;
-          }
-      }
-    while (s);
-    if (changed && !!(options_ & scc_info_options::TRACK_SUCCS))
+    for (unsigned s = 0; s < n; ++s)
+      if (!is_rejecting_scc(s) && !is_accepting_scc(s))
+        {
+          changed = true;
+          break;
+        }
+    if (!changed)
+      return;
+    if (SPOT_UNLIKELY(!aut_->is_existential()))
+      throw std::runtime_error("scc_info::determine_unknown_acceptance() "
+                               "does not support alternating automata");
+    if (SPOT_UNLIKELY(!(options_ & scc_info_options::TRACK_STATES)))
+      report_need_track_states();
+
+    // Each thread shares the scratch memory of all its emptiness
+    // checks.  The verdicts are only stored in node_ once all
+    // threads are done, since the flags of different SCCs may share
+    // the same memory location.
+    std::vector<scc_info_workspace> ws(ppolicy.nthreads());
+    std::vector<signed char> empty(n, -1);
+    parallel_for_each_scc(*this, ppolicy,
+                          [&](unsigned s, unsigned worker)
+                          {
+                            if (!is_rejecting_scc(s) && !is_accepting_scc(s))
+                              empty[s] =
+                                generic_emptiness_check_for_scc(*this, s,
+                                                                ws[worker]);
+                          });
+    for (unsigned s = 0; s < n; ++s)
+      if (empty[s] >= 0)
+        {
+          if (empty[s])
+            node_[s].rejecting_ = true;
+          else
+            node_[s].accepting_ = true;
+        }
+    if (!!(options_ & scc_info_options::TRACK_SUCCS))
       determine_usefulness();
   }
 
+  void
+  parallel_for_each_scc(const scc_info& si, parallel_policy ppolicy,
+                        const std::function<void(unsigned scc,
+                                                 unsigned worker)>& f)
+  {
+    parallel_for(ppolicy, si.scc_count(), f);
+  }
+
   // A reimplementation of spot::bfs_steps for explicit automata.
   // bool filter(const twa_graph::edge_storage_t&) returns true if the
   // transition has to be filtered out.
@@ -564,7 +661,7 @@ namespace spot
     // case of satisfying the condition with a larger cycle.  We do
     // this first, because it's good to return a small cycle if we
     // can.
-    const acc_cond& acccond = aut_->acc();
+    const acc_cond& acccond = *acc_;
     for (unsigned s: node.states())
       for (auto& e: aut_->out(s))
         if (e.src == e.dst && !filter(e) && acccond.accepting(e.acc))
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2014-2019 Laboratoire de Recherche et Développement
+// Copyright (C) 2014-2020 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <functional>
 #include <vector>
 #include <spot/twa/twagraph.hh>
 #include <spot/twaalgos/emptiness.hh>
@@ -352,6 +353,39 @@ namespace spot
 
   class SPOT_API scc_and_mark_filter;
 
+  /// \ingroup twa_misc
+  /// \brief Scratch memory that can be shared by several scc_info.
+  ///
+  /// Building an scc_info normally allocates and initializes several
+  /// vectors whose size is the number of states of the automaton,
+  /// even when an scc_and_mark_filter restricts the exploration to a
+  /// single SCC.  An scc_info built with a workspace borrows these
+  /// vectors instead, and only resets the entries of the states it
+  /// has visited when it is destroyed.  Repeatedly decomposing small
+  /// SCCs of a large automaton, as done by the generic emptiness
+  /// check, then costs time proportional to the size of these SCCs.
+  ///
+  /// The workspace must outlive all the scc_info built with it.  It
+  /// is not thread-safe.
+  class SPOT_API scc_info_workspace
+  {
+    friend class scc_info;
+    // Vectors ready to be used as scc_info::sccof_: all their entries
+    // are -1U.
+    std::vector<std::vector<unsigned>> sccof_pool_;
+    // Vectors ready to be used as scc_info::visited_: all are empty.
+    std::vector<std::vector<unsigned>> visited_pool_;
+    // Used only while an scc_info is built.  All entries of h_ are 0,
+    // all entries of init_seen_ are false, and live_ is empty.
+    std::vector<int> h_;
+    std::vector<bool> init_seen_;
+    std::vector<unsigned> live_;
+  public:
+    scc_info_workspace() = default;
+    scc_info_workspace(const scc_info_workspace&) = delete;
+    scc_info_workspace& operator=(const scc_info_workspace&) = delete;
+  };
+
   /// \ingroup twa_misc
   /// \brief Compute an SCC map and gather assorted information.
   ///
@@ -418,6 +452,49 @@ namespace spot
     void* filter_data_;
     int one_acc_scc_ = -1;
     scc_info_options options_;
+    // The acceptance condition used to classify SCCs.  This is the
+    // acceptance of aut_, unless a filter supplied another one.
+    const acc_cond* acc_;
+
+    // When sccof_ is borrowed from a workspace, visited_ lists the
+    // states whose entry must be reset before giving it back.  A
+    // copy of an scc_info owns its memory, while a move transfers
+    // the borrowed memory.  (Memory that is overwritten by an
+    // assignment is simply not given back to the workspace.)
+    struct workspace_ref
+    {
+      scc_info_workspace* ws = nullptr;
+      workspace_ref() = default;
+      workspace_ref(const workspace_ref&) noexcept
+      {
+      }
+      workspace_ref(workspace_ref&& o) noexcept
+        : ws(o.ws)
+      {
+        o.ws = nullptr;
+      }
+      workspace_ref& operator=(const workspace_ref&) noexcept
+      {
+        ws = nullptr;
+        return *this;
+      }
+      workspace_ref& operator=(workspace_ref&& o) noexcept
+      {
+        if (this != &o)
+          {
+            ws = o.ws;
+            o.ws = nullptr;
+          }
+        return *this;
+      }
+    };
+    workspace_ref ws_;
+    std::vector<unsigned> visited_;
+
+    scc_info(const_twa_graph_ptr aut, unsigned initial_state,
+             edge_filter filter, void* filter_data,
+             scc_info_options options, scc_info_workspace* ws,
+             const acc_cond* acc);
 
     // Update the useful_ bits.  Called automatically.
     void determine_usefulness();
@@ -443,7 +520,11 @@ namespace spot
              unsigned initial_state = ~0U,
              edge_filter filter = nullptr,
              void* filter_data = nullptr,
-             scc_info_options options = scc_info_options::ALL);
+             scc_info_options options = scc_info_options::ALL)
+      : scc_info(aut, initial_state, filter, filter_data, options,
+                 nullptr, nullptr)
+      {
+      }
 
     scc_info(const_twa_graph_ptr aut, scc_info_options options)
       : scc_info(aut, ~0U, nullptr, nullptr, options)
@@ -468,11 +549,40 @@ namespace spot
     }
     /// @}
 
+    /// \brief Create an scc_info map from some filter, using the
+    /// scratch memory of \a ws.
+    ///
+    /// When \a filt restricts the exploration to one SCC, the cost
+    /// of building (and destroying) this scc_info is proportional to
+    /// the size of that SCC rather than to the size of the
+    /// automaton.
+    scc_info(const scc_and_mark_filter& filt, scc_info_options options,
+             scc_info_workspace& ws);
+
+    scc_info(const scc_info&) = default;
+    scc_info& operator=(const scc_info&) = default;
+#ifndef SWIG
+    scc_info(scc_info&&) = default;
+    scc_info& operator=(scc_info&&) = default;
+#endif
+
+    ~scc_info();
+
     const_twa_graph_ptr get_aut() const
     {
       return aut_;
     }
 
+    /// \brief The acceptance condition used to classify the SCCs.
+    ///
+    /// This is the acceptance condition of get_aut(), unless this
+    /// scc_info was built from an scc_and_mark_filter that specified
+    /// another one with scc_and_mark_filter::use_acceptance().
+    const acc_cond& acc() const
+    {
+      return *acc_;
+    }
+
     scc_info_options get_options() const
     {
       return options_;
@@ -617,7 +727,10 @@ namespace spot
     /// accepting nor as rejecting because of the presence of Fin sets
     ///
     /// This simply calls check_scc_emptiness() on undeterminate SCCs.
-    void determine_unknown_acceptance();
+    /// With a \a ppolicy allowing several threads, these SCCs are
+    /// checked concurrently.
+    void determine_unknown_acceptance(parallel_policy ppolicy
+                                      = parallel_policy());
 
     /// \brief Recompute whether an SCC is accepting or not.
     ///
@@ -730,6 +843,10 @@ namespace spot
     const_twa_graph_ptr aut_;
     acc_cond old_acc_;
     bool restore_old_acc_ = false;
+    acc_cond acc_;
+    bool use_acc_ = false;
+    const std::vector<bool>* keep_states_ = nullptr;
+    unsigned init_ = 0;
 
     static scc_info::edge_filter_choice
     filter_scc_and_mark_(const twa_graph::edge_storage_t& e,
@@ -752,6 +869,18 @@ namespace spot
       return scc_info::edge_filter_choice::keep;
     };
 
+    static scc_info::edge_filter_choice
+    filter_states_and_mark_(const twa_graph::edge_storage_t& e,
+                            unsigned dst, void* data)
+    {
+      auto& d = *reinterpret_cast<scc_and_mark_filter*>(data);
+      if (!(*d.keep_states_)[dst])
+        return scc_info::edge_filter_choice::ignore;
+      if (d.cut_sets_ & e.acc)
+        return scc_info::edge_filter_choice::cut;
+      return scc_info::edge_filter_choice::keep;
+    };
+
   public:
     /// \brief Specify how to restrict scc_info to some SCC and acceptance sets
     ///
@@ -783,6 +912,33 @@ namespace spot
     {
     }
 
+    /// \brief Specify how to restrict scc_info to some states and
+    /// acceptance sets
+    ///
+    /// This makes it possible to work on the part of \a aut induced
+    /// by some states, without copying it, e.g. with
+    /// generic_emptiness_check(const scc_and_mark_filter&).
+    ///
+    /// \param aut the automaton to filter
+    /// \param keep_states a vector indexed by state numbers,
+    /// indicating the states to keep.  Edges going to other states
+    /// are ignored.  This vector is not copied, and should outlive
+    /// the filter.
+    /// \param init the state from which to start the exploration,
+    /// which should be kept.
+    /// \param cut_sets the acceptance sets that should not be part of SCCs.
+    scc_and_mark_filter(const const_twa_graph_ptr& aut,
+                        const std::vector<bool>& keep_states,
+                        unsigned init,
+                        acc_cond::mark_t cut_sets = {})
+      : lower_si_(nullptr), cut_sets_(cut_sets), aut_(aut),
+        old_acc_(aut_->get_acceptance()), keep_states_(&keep_states),
+        init_(init)
+    {
+      SPOT_ASSERT(keep_states.size() == aut->num_states());
+      SPOT_ASSERT(keep_states[init]);
+    }
+
     ~scc_and_mark_filter()
     {
       restore_acceptance();
@@ -802,6 +958,25 @@ namespace spot
       restore_old_acc_ = false;
     }
 
+    /// \brief Classify the SCCs using \a new_acc.
+    ///
+    /// Contrary to override_acceptance(), this does not modify the
+    /// automaton: only the scc_info built from this filter uses \a
+    /// new_acc.  Several such filters can therefore be used
+    /// concurrently on the same automaton.
+    void use_acceptance(const acc_cond& new_acc)
+    {
+      acc_ = new_acc;
+      use_acc_ = true;
+    }
+
+    /// \brief The acceptance condition to use for the scc_info built
+    /// from this filter.
+    const acc_cond& get_acceptance() const
+    {
+      return use_acc_ ? acc_ : aut_->acc();
+    }
+
     const_twa_graph_ptr get_aut() const
     {
       return aut_;
@@ -811,6 +986,8 @@ namespace spot
     {
       if (lower_si_)
         return lower_si_->one_state_of(lower_scc_);
+      if (keep_states_)
+        return init_;
       return aut_->get_init_state_number();
     }
 
@@ -818,6 +995,8 @@ namespace spot
     {
       if (lower_si_)
         return filter_scc_and_mark_;
+      if (keep_states_)
+        return filter_states_and_mark_;
       if (cut_sets_)
         return filter_mark_;
       return nullptr;
@@ -825,6 +1004,33 @@ namespace spot
   };
 
 
+#ifndef SWIG
+  /// \brief Call \a f on each SCC of \a si, using several threads.
+  ///
+  /// \a f is called as f(scc, worker) where \a worker is the number
+  /// (between 0 and ppolicy.nthreads()-1) of the thread processing
+  /// \a scc.  It can be used to index some per-thread scratch space.
+  /// The SCCs are distributed dynamically between the threads, so
+  /// the order in which they are processed is unspecified: to obtain
+  /// deterministic results, \a f should store its result in a vector
+  /// indexed by SCC numbers, and these results should be merged once
+  /// this function returns.
+  ///
+  /// \a f may not modify the automaton, nor create or destroy BDDs or
+  /// formulas, since neither BuDDy nor the formula hash tables are
+  /// thread-safe.
+  ///
+  /// If \a f throws an exception, no new SCC is processed, and the
+  /// first exception is rethrown once all threads have stopped.
+  ///
+  /// With a single thread, this is just a loop over all SCCs in
+  /// increasing order.
+  SPOT_API void
+  parallel_for_each_scc(const scc_info& si, parallel_policy ppolicy,
+                        const std::function<void(unsigned scc,
+                                                 unsigned worker)>& f);
+#endif
+
   /// \brief Dump the SCC graph of \a aut on \a out.
   ///
   /// If \a sccinfo is not given, it will be computed.
@@ -31,6 +31,7 @@
 #endif
 
 #include <cassert>
+#include <cstring>
 #include <list>
 #include <spot/misc/hash.hh>
 #include <spot/twa/twa.hh>
@@ -58,7 +59,8 @@ namespace spot
       se05_search(const const_twa_ptr a, size_t size,
                   option_map o = option_map())
         : emptiness_check(a, o),
-          h(size)
+          h(a, size),
+          batch_(a->has_native_succ_batch())
       {
         if (!(a->prop_weak().is_true()
               || a->num_sets() == 0
@@ -68,18 +70,16 @@ namespace spot
 
       virtual ~se05_search()
       {
-        // Release all iterators on the stacks.
+        // Release all iterators and successors on the stacks.
         while (!st_blue.empty())
           {
             h.pop_notify(st_blue.front().s);
-            a_->release_iter(st_blue.front().it);
-            st_blue.pop_front();
+            pop(st_blue);
           }
         while (!st_red.empty())
           {
             h.pop_notify(st_red.front().s);
-            a_->release_iter(st_red.front().it);
-            st_red.pop_front();
+            pop(st_red);
           }
       }
 
@@ -153,20 +153,74 @@ namespace spot
       }
     private:
 
+      std::vector<twa_succ_record>& succs_of(const stack_type& st)
+      {
+        return &st == &st_blue ? succ_blue : succ_red;
+      }
+
       void push(stack_type& st, const state* s,
                 const bdd& label, acc_cond::mark_t acc)
       {
         inc_depth();
-        twa_succ_iterator* i = a_->succ_iter(s);
-        i->first();
-        st.emplace_front(s, i, label, acc);
+        if (batch_)
+          {
+            auto& succs = succs_of(st);
+            unsigned b = succs.size();
+            a_->succ_batch(s, succs);
+            st.emplace_front(s, nullptr, label, acc);
+            st.front().pos = b;
+            st.front().end = succs.size();
+          }
+        else
+          {
+            twa_succ_iterator* i = a_->succ_iter(s);
+            i->first();
+            st.emplace_front(s, i, label, acc);
+          }
       }
 
       void pop(stack_type& st)
       {
         dec_depth();
-        a_->release_iter(st.front().it);
-        st.pop_front();
+        stack_item& f = st.front();
+        if (f.it)
+          {
+            a_->release_iter(f.it);
+            st.pop_front();
+          }
+        else
+          {
+            auto& succs = succs_of(st);
+            for (unsigned j = f.pos; j < f.end; ++j)
+              succs[j].dst->destroy();
+            st.pop_front();
+            succs.resize(st.empty() ? 0 : st.front().end);
+          }
+      }
+
+      bool done(const stack_item& f) const
+      {
+        return f.it ? f.it->done() : f.pos == f.end;
+      }
+
+      /// \brief Return the next successor of \a f (on the stack \a
+      /// st), and the label and acceptance set of the edge leading to
+      /// it.
+      const state* next_succ(stack_type& st, stack_item& f,
+                             bdd& label, acc_cond::mark_t& acc)
+      {
+        if (f.it)
+          {
+            const state* s = f.it->dst();
+            label = f.it->cond();
+            acc = f.it->acc();
+            f.it->next();
+            return s;
+          }
+        const twa_succ_record& r = succs_of(st)[f.pos++];
+        label = r.cond;
+        acc = r.acc;
+        return r.dst;
       }
 
       /// \brief Stack of the blue dfs.
@@ -175,25 +229,32 @@ namespace spot
       /// \brief Stack of the red dfs.
       stack_type st_red;
 
+      /// \brief Successors of the states of \a st_blue and \a st_red,
+      /// when the automaton has a native twa::succ_batch().
+      std::vector<twa_succ_record> succ_blue;
+      std::vector<twa_succ_record> succ_red;
+
       /// \brief Map where each visited state is colored
       /// by the last dfs visiting it.
       heap h;
 
+      /// \brief Whether to use twa::succ_batch() instead of iterators.
+      bool batch_;
+
       bool dfs_blue()
       {
         while (!st_blue.empty())
           {
             stack_item& f = st_blue.front();
             trace << "DFS_BLUE treats: " << a_->format_state(f.s) << std::endl;
-            if (!f.it->done())
+            if (!done(f))
               {
-                const state *s_prime = f.it->dst();
+                bdd label;
+                acc_cond::mark_t acc;
+                // Go down the edge (f.s, <label, acc>, s_prime)
+                const state *s_prime = next_succ(st_blue, f, label, acc);
                 trace << "  Visit the successor: "
                       << a_->format_state(s_prime) << std::endl;
-                bdd label = f.it->cond();
-                auto acc = f.it->acc();
-                // Go down the edge (f.s, <label, acc>, s_prime)
-                f.it->next();
                 inc_transitions();
                 typename heap::color_ref c = h.get_color_ref(s_prime);
                 if (c.is_white())
@@ -276,15 +337,14 @@ namespace spot
           {
             stack_item& f = st_red.front();
             trace << "DFS_RED treats: " << a_->format_state(f.s) << std::endl;
-            if (!f.it->done())
+            if (!done(f))
               {
-                const state *s_prime = f.it->dst();
+                bdd label;
+                acc_cond::mark_t acc;
+                // Go down the edge (f.s, <label, acc>, s_prime)
+                const state *s_prime = next_succ(st_red, f, label, acc);
                 trace << "  Visit the successor: "
                       << a_->format_state(s_prime) << std::endl;
-                bdd label = f.it->cond();
-                auto acc = f.it->acc();
-                // Go down the edge (f.s, <label, acc>, s_prime)
-                f.it->next();
                 inc_transitions();
                 typename heap::color_ref c = h.get_color_ref(s_prime);
                 if (c.is_white())
@@ -442,8 +502,8 @@ namespace spot
 
     class explicit_se05_search_heap final
     {
-      typedef state_set hcyan_type;
-      typedef state_map<color> hash_type;
+      typedef state_open_set hcyan_type;
+      typedef state_open_map<color> hash_type;
     public:
       enum { Safe = 1 };
 
@@ -492,7 +552,7 @@ namespace spot
         color *pc; // point to the color of a state stored in main hash table
       };
 
-      explicit_se05_search_heap(size_t)
+      explicit_se05_search_heap(const const_twa_ptr&, size_t)
         {
         }
 
@@ -621,7 +681,7 @@ namespace spot
         unsigned char o;
       };
 
-      bsh_se05_search_heap(size_t s) : size_(s)
+      bsh_se05_search_heap(const const_twa_ptr&, size_t s) : size_(s)
         {
           h = new unsigned char[size_];
           memset(h, WHITE, size_);
@@ -675,6 +735,91 @@ namespace spot
       hcyan_type hc;
     };
 
+    // Like explicit_se05_search_heap, the colors of all visited
+    // states are stored exactly.  However states are stored by
+    // their packed representation (see twa::pack_state()) inline in
+    // an open-addressing table, so that state objects do not have
+    // to be kept once they leave the stacks.  Cyan states are stored
+    // in that table too.
+    template<unsigned N>
+    class packed_se05_search_heap final
+    {
+      typedef packed_state_open_map<N, color> hash_type;
+    public:
+      enum { Safe = 1 };
+
+      class color_ref final
+      {
+      public:
+        color_ref(color* c)
+          : pc(c)
+          {
+          }
+        color get_color() const
+          {
+            return pc ? *pc : WHITE;
+          }
+        void set_color(color c)
+          {
+            assert(!is_white());
+            *pc = c;
+          }
+        bool is_white() const
+          {
+            return !pc;
+          }
+      private:
+        color* pc; // the color of the state in the table, if any
+      };
+
+      packed_se05_search_heap(const const_twa_ptr& a, size_t)
+        : a_(a)
+        {
+          assert(a->packed_state_words() == N);
+        }
+
+      color_ref get_color_ref(const state*& s)
+        {
+          auto it = h.find(pack(s));
+          if (it == h.end())
+            return color_ref(nullptr); // white state
+          return color_ref(&it->second);
+        }
+
+      void add_new_state(const state* s, color c)
+        {
+          assert(!has_been_visited(s));
+          h.emplace(pack(s), c);
+        }
+
+      void pop_notify(const state* s) const
+        {
+          s->destroy();
+        }
+
+      bool has_been_visited(const state* s) const
+        {
+          return h.count(pack(s));
+        }
+
+      enum { Has_Size = 1 };
+      int size() const
+        {
+          return h.size();
+        }
+
+    private:
+      packed_state<N> pack(const state* s) const
+        {
+          packed_state<N> p;
+          a_->pack_state(s, p.words);
+          return p;
+        }
+
+      const_twa_ptr a_;
+      hash_type h; // the color of each visited state
+    };
+
   } // anonymous
 
   emptiness_check_ptr
@@ -694,12 +839,40 @@ namespace spot
                                  a, size, o);
   }
 
+  emptiness_check_ptr
+  packed_se05_search(const const_twa_ptr& a, option_map o)
+  {
+    switch (a->packed_state_words())
+      {
+      case 1:
+        return
+          SPOT_make_shared_enabled__(se05_search<packed_se05_search_heap<1>>,
+                                     a, 0, o);
+      case 2:
+        return
+          SPOT_make_shared_enabled__(se05_search<packed_se05_search_heap<2>>,
+                                     a, 0, o);
+      case 3:
+        return
+          SPOT_make_shared_enabled__(se05_search<packed_se05_search_heap<3>>,
+                                     a, 0, o);
+      case 4:
+        return
+          SPOT_make_shared_enabled__(se05_search<packed_se05_search_heap<4>>,
+                                     a, 0, o);
+      default:
+        return explicit_se05_search(a, o);
+      }
+  }
+
   emptiness_check_ptr
   se05(const const_twa_ptr& a, option_map o)
   {
     size_t size = o.get("bsh");
     if (size)
       return bit_state_hashing_se05_search(a, size, o);
+    if (o.get("packed"))
+      return packed_se05_search(a, o);
     return explicit_se05_search(a, o);
   }
 
@@ -114,12 +114,30 @@ namespace spot
                                 option_map o = option_map());
 
 
-  /// \brief Wrapper for the two se05 implementations.
+  /// \brief Returns an emptiness checker on the spot::tgba automaton \a a.
+  ///
+  /// \pre The automaton \a a must have at most one acceptance condition (i.e.
+  /// it is a TBA).
+  ///
+  /// This is the same algorithm as spot::explicit_se05_search, and it
+  /// also stores all the traversed states, but it stores them using
+  /// their packed representation (see twa::pack_state()) instead of
+  /// keeping the state objects.  If \a a does not support packed
+  /// states, or if its states need more than 4 words, this returns
+  /// explicit_se05_search(a, o).
+  ///
+  /// \sa spot::explicit_se05_search
+  ///
+  SPOT_API emptiness_check_ptr
+  packed_se05_search(const const_twa_ptr& a, option_map o = option_map());
+
+  /// \brief Wrapper for the se05 implementations.
   ///
-  /// This wrapper calls explicit_se05_search() or
-  /// bit_state_hashing_se05_search() according to the \c "bsh" option
-  /// in the \c option_map.  If \c "bsh" is set and non null, its value
-  /// is used as the size of the hash map.
+  /// This wrapper calls explicit_se05_search(),
+  /// bit_state_hashing_se05_search(), or packed_se05_search()
+  /// according to the \c "bsh" and \c "packed" options in the \c
+  /// option_map.  If \c "bsh" is set and non null, its value is used
+  /// as the size of the hash map.
   SPOT_API emptiness_check_ptr
   se05(const const_twa_ptr& a, option_map o);
 
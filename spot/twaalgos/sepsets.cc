@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2015-2019 Laboratoire de Recherche et
+// Copyright (C) 2015-2020 Laboratoire de Recherche et
 // Développement de l'Epita.
 //
 // This file is part of Spot, a model checking library.
@@ -54,7 +54,7 @@ namespace spot
     }
 
     // Fix the acceptance condition
-    auto& code = aut->acc().get_acceptance();
+    auto code = aut->get_acceptance();
     // If code were empty, then common would have been 0.
     assert(!code.empty());
     acc_cond::acc_word* pos = &code.back();
@@ -83,6 +83,7 @@ namespace spot
             break;
           }
       }
+    aut->acc().set_acceptance(code);
 
     // Fix the edges
     for (auto& t: aut->edges())
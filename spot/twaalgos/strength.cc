@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2010-2011, 2013-2018 Laboratoire de Recherche et
+// Copyright (C) 2010-2011, 2013-2020 Laboratoire de Recherche et
 // Développement de l'Epita (LRDE)
 //
 // This file is part of Spot, a model checking library.
@@ -32,53 +32,89 @@ namespace spot
 {
   namespace
   {
+    // Whether all the edges inside SCC I carry the same marks.
+    static bool
+    has_uniform_marks(const const_twa_graph_ptr& aut,
+                      const scc_info& si, unsigned i)
+    {
+      bool first = true;
+      acc_cond::mark_t m = {};
+      for (auto& t: si.edges_of(i))
+        // In case of a universal edge we only need to check if
+        // the first destination of an edge is inside the SCC,
+        // because the others have the same t.acc.
+        if (si.scc_of(*aut->univ_dests(t.dst).begin()) == i)
+          {
+            if (first)
+              {
+                first = false;
+                m = t.acc;
+              }
+            else if (m != t.acc)
+              {
+                return false;
+              }
+          }
+      return true;
+    }
+
     template <bool terminal, bool inweak = false, bool set = false>
     bool is_type_automaton(const twa_graph_ptr& aut, scc_info* si,
-                           bool ignore_trivial_term = false)
+                           bool ignore_trivial_term = false,
+                           parallel_policy ppolicy = parallel_policy())
     {
       // Create an scc_info if the user did not give one to us.
       bool need_si = !si;
       if (need_si)
         si = new scc_info(aut);
       if (inweak)
-        si->determine_unknown_acceptance();
+        si->determine_unknown_acceptance(ppolicy);
+
+      unsigned n = si->scc_count();
+      // With several threads, classify all SCCs concurrently first.
+      // Sequentially, the classification is done lazily below, so we
+      // can stop at the first SCC that decides the answer.
+      std::vector<char> uniform;
+      std::vector<char> rejcycle;
+      if (ppolicy.nthreads() > 1)
+        {
+          uniform.resize(n);
+          rejcycle.resize(n);
+          parallel_for_each_scc(*si, ppolicy, [&](unsigned i, unsigned)
+            {
+              if (si->is_trivial(i))
+                return;
+              uniform[i] = has_uniform_marks(aut, *si, i);
+              if (inweak && !uniform[i] && si->is_accepting_scc(i))
+                rejcycle[i] = scc_has_rejecting_cycle(*si, i);
+            });
+        }
 
       bool is_inweak = true;
       bool is_weak = true;
       bool is_single_state_scc = true;
       bool is_term = true;
-      unsigned n = si->scc_count();
       for (unsigned i = 0; i < n; ++i)
         {
           if (si->is_trivial(i))
             continue;
           if (si->states_of(i).size() > 1)
             is_single_state_scc = false;
-          bool first = true;
-          acc_cond::mark_t m = {};
-          if (is_weak)
-            for (auto& t: si->edges_of(i))
-              // In case of a universal edge we only need to check if
-              // the first destination of an edge is inside the SCC,
-              // because the others have the same t.acc.
-              if (si->scc_of(*aut->univ_dests(t.dst).begin()) == i)
-                {
-                  if (first)
-                    {
-                      first = false;
-                      m = t.acc;
-                    }
-                  else if (m != t.acc)
-                    {
-                      is_weak = false;
-                      if (!inweak)
-                        goto exit;
-                    }
-                }
-          if (!is_weak && si->is_accepting_scc(i))
+          bool uni = !uniform.empty() ? uniform[i]
+            : has_uniform_marks(aut, *si, i);
+          if (!uni)
+            {
+              is_weak = false;
+              if (!inweak)
+                goto exit;
+            }
+          // An accepting SCC whose edges all carry the same marks
+          // cannot have a rejecting cycle.
+          if (!uni && si->is_accepting_scc(i))
             {
               assert(inweak);
-              if (scc_has_rejecting_cycle(*si, i))
+              if (!rejcycle.empty() ? rejcycle[i]
+                  : scc_has_rejecting_cycle(*si, i))
                 {
                   is_inweak = false;
                   break;
@@ -174,12 +210,13 @@ namespace spot
     return res;
   }
 
-  void check_strength(const twa_graph_ptr& aut, scc_info* si)
+  void check_strength(const twa_graph_ptr& aut, scc_info* si,
+                      parallel_policy ppolicy)
   {
     if (!aut->is_existential())
-      is_type_automaton<false, false, true>(aut, si);
+      is_type_automaton<false, false, true>(aut, si, false, ppolicy);
     else
-      is_type_automaton<true, true, true>(aut, si);
+      is_type_automaton<true, true, true>(aut, si, false, ppolicy);
   }
 
   bool is_safety_automaton(const const_twa_graph_ptr& aut, scc_info* si)
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2010-2011, 2013-2019 Laboratoire de Recherche et
+// Copyright (C) 2010-2011, 2013-2020 Laboratoire de Recherche et
 // Développement de l'Epita (LRDE)
 //
 // This file is part of Spot, a model checking library.
@@ -133,8 +133,12 @@ namespace spot
   ///
   /// \param sm an scc_info object for the automaton if available (it
   /// will be built otherwise).
+  ///
+  /// \param ppolicy how many threads may be used to classify the
+  /// SCCs of \a aut.
   SPOT_API void
-  check_strength(const twa_graph_ptr& aut, scc_info* sm = nullptr);
+  check_strength(const twa_graph_ptr& aut, scc_info* sm = nullptr,
+                 parallel_policy ppolicy = parallel_policy());
 
 
   /// \brief Extract a sub-automaton of a given strength
@@ -368,7 +368,7 @@ namespace spot
           return h.size();
         }
     private:
-      state_map<std::pair<color, acc_cond::mark_t>> h;
+      state_open_map<std::pair<color, acc_cond::mark_t>> h;
     };
 
   } // anonymous
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2013-2018 Laboratoire de Recherche et Développement
+// Copyright (C) 2013-2018, 2020 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -29,16 +29,97 @@
 #include <spot/twaalgos/product.hh>
 #include <spot/twaalgos/sccinfo.hh>
 #include <spot/twaalgos/hoa.hh>
+#include <spot/twaalgos/sccfilter.hh>
+#include <spot/tl/apcollect.hh>
+#include <spot/misc/timer.hh>
 
 namespace spot
 {
+  namespace
+  {
+    // Combine all automata of AUTS using PROD, starting with the
+    // two smallest ones, and simplifying each intermediate product.
+    // Among automata of equal size, the earliest ones are combined
+    // first, and each product replaces its left operand, so that
+    // this is the same as a chain of products for up to three
+    // automata of equal size.
+    template<typename Prod>
+    static twa_graph_ptr
+    balanced_product(std::vector<twa_graph_ptr>& auts, Prod prod)
+    {
+      assert(!auts.empty());
+      while (auts.size() > 1)
+        {
+          unsigned sz = auts.size();
+          unsigned m1 = 0;
+          for (unsigned i = 1; i < sz; ++i)
+            if (auts[i]->num_states() < auts[m1]->num_states())
+              m1 = i;
+          unsigned m2 = m1 == 0 ? 1 : 0;
+          for (unsigned i = m2 + 1; i < sz; ++i)
+            if (i != m1 && auts[i]->num_states() < auts[m2]->num_states())
+              m2 = i;
+          unsigned lo = std::min(m1, m2);
+          unsigned hi = std::max(m1, m2);
+          auts[lo] = scc_filter(prod(auts[lo], auts[hi]));
+          auts.erase(auts.begin() + hi);
+        }
+      return auts.front();
+    }
+
+    // Partition the operands of F into groups that share no atomic
+    // proposition.  G(f1 & f2 & ...) is handled as Gf1 & Gf2 & ...
+    static std::vector<formula>
+    split_independent(formula f)
+    {
+      if (f.is(op::G) && f[0].is(op::And))
+        {
+          std::vector<formula> res = split_independent(f[0]);
+          for (auto& g: res)
+            g = formula::G(g);
+          return res;
+        }
+      unsigned sz = f.size();
+      // Union-find over the operands of f.
+      std::vector<unsigned> parent(sz);
+      for (unsigned i = 0; i < sz; ++i)
+        parent[i] = i;
+      auto find = [&](unsigned i)
+        {
+          while (parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+          return i;
+        };
+      std::map<formula, unsigned> owner;
+      for (unsigned i = 0; i < sz; ++i)
+        f[i].traverse([&](const formula& g)
+                      {
+                        if (!g.is(op::ap))
+                          return false;
+                        auto p = owner.emplace(g, i);
+                        if (!p.second)
+                          parent[find(i)] = find(p.first->second);
+                        return true;
+                      });
+      std::map<unsigned, std::vector<formula>> groups;
+      for (unsigned i = 0; i < sz; ++i)
+        groups[find(i)].push_back(f[i]);
+      std::vector<formula> res;
+      for (auto& g: groups)
+        res.push_back(formula::multop(f.kind(), std::move(g.second)));
+      return res;
+    }
+  }
 
   void translator::setup_opt(const option_map* opt)
   {
     comp_susp_ = early_susp_ = skel_wdba_ = skel_simul_ = 0;
     relabel_bool_ = 4;
     tls_impl_ = -1;
-    ltl_split_ = true;
+    tls_wide_ = 0;
+    tls_cache_size_ = 0;
+    fm_cache_opt_ = false;
+    ltl_split_ = 1;
 
     opt_ = opt;
     if (!opt)
@@ -53,6 +134,9 @@ namespace spot
         skel_simul_ = opt->get("skel-simul", 1);
       }
     tls_impl_ = opt->get("tls-impl", -1);
+    tls_wide_ = opt->get("tls-wide", 0);
+    tls_cache_size_ = opt->get("tls-cache-size", 0);
+    fm_cache_opt_ = opt->get("fm-cache", 0);
     int gfg = opt->get("gf-guarantee", -1);
     if (gfg >= 0)
       {
@@ -106,6 +190,8 @@ namespace spot
           throw std::runtime_error
             ("tls-impl should take a value between 0 and 3");
         }
+    options.wide_multop_threshold = tls_wide_;
+    options.cache_size_limit = tls_cache_size_ * size_t(1024);
     if (comp_susp_ > 0 || (ltl_split_ && type_ == Generic))
       options.favor_event_univ = true;
     simpl_owned_ = simpl_ = new tl_simplifier(options, dict);
@@ -131,6 +217,8 @@ namespace spot
 
     twa_graph_ptr aut;
     twa_graph_ptr aut2 = nullptr;
+    // Subformulas translated separately, with their translation time.
+    translation_parts parts;
 
     if (ltl_split_ && !r.is_syntactic_obligation())
       {
@@ -238,10 +326,29 @@ namespace spot
         translate_without_split.set_type(type_);
         auto transrun = [&](formula f)
           {
-            if (f == r2)
-              return translate_without_split.run(f);
+            stopwatch sw;
+            sw.start();
+            twa_graph_ptr res = (f == r2)
+              ? translate_without_split.run(f) : run(f);
+            parts.emplace_back(f, sw.stop());
+            return res;
+          };
+        auto combine = [&](std::vector<twa_graph_ptr>& auts)
+          {
+            if (is_and)
+              return balanced_product(auts,
+                                      [](const const_twa_graph_ptr& l,
+                                         const const_twa_graph_ptr& r)
+                                      {
+                                        return product(l, r);
+                                      });
             else
-              return run(f);
+              return balanced_product(auts,
+                                      [](const const_twa_graph_ptr& l,
+                                         const const_twa_graph_ptr& r)
+                                      {
+                                        return product_or(l, r);
+                                      });
           };
 
         // std::cerr << "splitting\n";
@@ -257,29 +364,54 @@ namespace spot
           {
             formula rest_f = formula::multop(r2.kind(), rest);
             //std::cerr << "rest: " << rest_f << '\n';
-            twa_graph_ptr rest_aut = transrun(rest_f);
-            if (aut == nullptr)
-              aut = rest_aut;
-            else if (is_and)
-              aut = product(aut, rest_aut);
+            std::vector<formula> groups;
+            if (ltl_split_ > 1 && is_and
+                && (rest_f.is(op::And)
+                    || (rest_f.is(op::G) && rest_f[0].is(op::And))))
+              groups = split_independent(rest_f);
+            if (groups.size() > 1)
+              {
+                std::vector<twa_graph_ptr> auts;
+                if (aut)
+                  auts.push_back(aut);
+                for (formula g: groups)
+                  auts.push_back(transrun(g));
+                aut = combine(auts);
+              }
             else
-              aut = product_or(aut, rest_aut);
+              {
+                twa_graph_ptr rest_aut = transrun(rest_f);
+                if (aut == nullptr)
+                  aut = rest_aut;
+                else if (is_and)
+                  aut = product(aut, rest_aut);
+                else
+                  aut = product_or(aut, rest_aut);
+              }
           }
         if (!susp.empty())
           {
             twa_graph_ptr susp_aut = nullptr;
             // Each suspendable formula separately
-            for (formula f: susp)
+            if (ltl_split_ > 1)
               {
-                //std::cerr << "susp: " << f << '\n';
-                twa_graph_ptr one = transrun(f);
-                if (!susp_aut)
-                  susp_aut = one;
-                else if (is_and)
-                  susp_aut = product(susp_aut, one);
-                else
-                  susp_aut = product_or(susp_aut, one);
+                std::vector<twa_graph_ptr> auts;
+                for (formula f: susp)
+                  auts.push_back(transrun(f));
+                susp_aut = combine(auts);
               }
+            else
+              for (formula f: susp)
+                {
+                  //std::cerr << "susp: " << f << '\n';
+                  twa_graph_ptr one = transrun(f);
+                  if (!susp_aut)
+                    susp_aut = one;
+                  else if (is_and)
+                    susp_aut = product(susp_aut, one);
+                  else
+                    susp_aut = product_or(susp_aut, one);
+                }
             if (susp_aut->prop_universal().is_true())
               {
                 // In a deterministic and suspendable automaton, all
@@ -366,9 +498,11 @@ namespace spot
               }
           }
         bool exprop = unambiguous || level_ == postprocessor::High;
+        if (fm_cache_opt_ && !fm_cache_)
+          fm_cache_ = new fm_fragment_cache(simpl_->get_dict());
         aut = ltl_to_tgba_fm(r, simpl_->get_dict(), exprop,
                              true, false, false, nullptr, nullptr,
-                             unambiguous);
+                             unambiguous, fm_cache_);
       }
 
     aut = this->postprocessor::run(aut, r);
@@ -384,7 +518,10 @@ namespace spot
                 && ((aut2->num_sets() < aut2->num_sets()) || d2_more_det)))
           aut = std::move(aut2);
       }
-
+    // A single part means the formula was translated as a whole.
+    if (parts.size() > 1)
+      aut->set_named_prop("translation-parts",
+                          new translation_parts(std::move(parts)));
     return aut;
   }
 
@@ -438,7 +575,13 @@ namespace spot
     auto aut = run_aux(r);
 
     if (!m.empty())
-      relabel_here(aut, &m);
+      {
+        relabel_here(aut, &m);
+        if (auto parts =
+            aut->get_named_prop<translation_parts>("translation-parts"))
+          for (auto& p: *parts)
+            p.first = relabel_apply(p.first, &m);
+      }
     return aut;
   }
 
@@ -450,5 +593,121 @@ namespace spot
   void translator::clear_caches()
   {
     simpl_->clear_caches();
+    if (fm_cache_)
+      fm_cache_->clear();
+  }
+
+  incremental_translator::~incremental_translator()
+  {
+    delete si_;
+  }
+
+  namespace
+  {
+    struct prod_filter_data
+    {
+      const scc_info* si;
+      const product_states* ps;
+    };
+
+    // A cycle of the product of aut_ with a conjunct projects onto a
+    // cycle of aut_, so the product only needs to be explored along
+    // edges whose projection stays in a useful SCC of aut_.
+    scc_info::edge_filter_choice
+    prod_filter(const twa_graph::edge_storage_t& e, unsigned dst,
+                void* data)
+    {
+      auto& d = *static_cast<prod_filter_data*>(data);
+      unsigned src_scc = d.si->scc_of((*d.ps)[e.src].first);
+      unsigned dst_scc = d.si->scc_of((*d.ps)[dst].first);
+      if (!d.si->is_useful_scc(dst_scc))
+        return scc_info::edge_filter_choice::ignore;
+      if (src_scc != dst_scc)
+        return scc_info::edge_filter_choice::cut;
+      return scc_info::edge_filter_choice::keep;
+    }
+  }
+
+  twa_graph_ptr incremental_translator::add(formula f)
+  {
+    // Once the conjunction is empty, it remains empty.
+    if (aut_ && is_empty())
+      {
+        conjuncts_.push_back(f);
+        parts_.push_back(nullptr);
+        return aut_;
+      }
+
+    twa_graph_ptr part = translator::run(&f);
+    conjuncts_.push_back(f);
+    parts_.push_back(part);
+    // Conjuncts equivalent to true do not change the product, and
+    // we can keep its SCC decomposition.
+    if (aut_ && f.is_tt())
+      return aut_;
+
+    if (!aut_ || f.is_ff())
+      {
+        aut_ = part;
+      }
+    else
+      {
+        // Check the emptiness of the product using the SCCs of the
+        // previous automaton (computed by is_empty() above), so that
+        // an unsatisfiable conjunction is not post-processed.  The
+        // formula is not passed to the post-processor, as it would
+        // translate the negation of the whole conjunction.
+        auto prod = product(aut_, part);
+        prod_filter_data data = { &get_scc_info(),
+          prod->get_named_prop<product_states>("product-states") };
+        scc_info psi(prod, prod->get_init_state_number(),
+                     prod_filter, &data,
+                     scc_info_options::STOP_ON_ACC
+                     | scc_info_options::TRACK_STATES_IF_FIN_USED);
+        psi.determine_unknown_acceptance();
+        if (psi.one_accepting_scc() < 0)
+          aut_ = translator::run(formula::ff());
+        else
+          aut_ = this->postprocessor::run(prod, nullptr);
+      }
+    delete si_;
+    si_ = nullptr;
+    return aut_;
+  }
+
+  twa_graph_ptr incremental_translator::automaton()
+  {
+    if (!aut_)
+      aut_ = translator::run(formula::tt());
+    return aut_;
+  }
+
+  formula incremental_translator::conjunction() const
+  {
+    return formula::And(conjuncts_);
+  }
+
+  const scc_info& incremental_translator::get_scc_info()
+  {
+    if (!si_)
+      {
+        si_ = new scc_info(automaton());
+        si_->determine_unknown_acceptance();
+      }
+    return *si_;
+  }
+
+  bool incremental_translator::is_empty()
+  {
+    return get_scc_info().one_accepting_scc() < 0;
+  }
+
+  void incremental_translator::clear()
+  {
+    conjuncts_.clear();
+    parts_.clear();
+    aut_ = nullptr;
+    delete si_;
+    si_ = nullptr;
   }
 }
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2013-2018 Laboratoire de Recherche et Développement
+// Copyright (C) 2013-2018, 2020 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -21,9 +21,19 @@
 
 #include <spot/twaalgos/postproc.hh>
 #include <spot/tl/simplify.hh>
+#include <spot/twaalgos/ltl2tgba_fm.hh>
 
 namespace spot
 {
+  /// \ingroup twa_ltl
+  /// \brief Automata built by translator by translating some
+  /// subformulas separately (see the \c ltl-split option) contain a
+  /// property named "translation-parts" with this type.
+  ///
+  /// Each pair gives one of these subformulas, and the wall-clock
+  /// time (in seconds) spent translating it.
+  typedef std::vector<std::pair<formula, double>> translation_parts;
+
   /// \ingroup twa_ltl
   /// \brief Translate an LTL formula into an optimized spot::tgba.
   ///
@@ -89,6 +99,7 @@ namespace spot
     {
       // simpl_owned_ is 0 if simpl_ was supplied to the constructor.
       delete simpl_owned_;
+      delete fm_cache_;
     }
 
     using postprocessor::output_type;
@@ -134,7 +145,8 @@ namespace spot
     /// by the simplified version.
     twa_graph_ptr run(formula* f);
 
-    /// \brief Clear the LTL simplification caches.
+    /// \brief Clear the LTL simplification caches, and the
+    /// translation cache enabled by the \c fm-cache option.
     void clear_caches();
 
   protected:
@@ -151,11 +163,141 @@ namespace spot
     int skel_simul_;
     int relabel_bool_;
     int tls_impl_;
+    unsigned tls_wide_;
+    unsigned tls_cache_size_;
+    bool fm_cache_opt_;
+    fm_fragment_cache* fm_cache_ = nullptr;
     bool gf_guarantee_ = true;
     bool gf_guarantee_set_ = false;
-    bool ltl_split_;
+    int ltl_split_;
     const option_map* opt_;
   };
+
+  class scc_info;
+
+  /// \brief Translate a conjunction of formulas given one at a time.
+  ///
+  /// Each call to add() translates only the new conjunct, using the
+  /// settings of spot::translator, and intersects the resulting
+  /// automaton with the automaton of the previous conjuncts.  This
+  /// product is then post-processed (again using the settings of
+  /// spot::translator, but without the formula, so that the
+  /// conjunction is never translated) to keep it small.  The SCCs of
+  /// the previous automaton are used to check the emptiness of the
+  /// product first, so that an unsatisfiable conjunction is not
+  /// post-processed.
+  ///
+  /// The automaton obtained this way recognizes the same language
+  /// as the translation of the conjunction, but may be larger.
+  ///
+  /// The type, preferences, and level should be set before the
+  /// first call to add().
+  class SPOT_API incremental_translator: protected translator
+  {
+  public:
+    incremental_translator(tl_simplifier* simpl,
+                           const option_map* opt = nullptr)
+      : translator(simpl, opt)
+    {
+    }
+
+    incremental_translator(const bdd_dict_ptr& dict,
+                           const option_map* opt = nullptr)
+      : translator(dict, opt)
+    {
+    }
+
+    incremental_translator(const option_map* opt = nullptr)
+      : translator(opt)
+    {
+    }
+
+    incremental_translator(const incremental_translator&) = delete;
+    incremental_translator&
+    operator=(const incremental_translator&) = delete;
+
+    ~incremental_translator();
+
+    using translator::output_type;
+
+    void
+    set_type(output_type type)
+    {
+      this->translator::set_type(type);
+    }
+
+    using translator::output_pref;
+
+    void
+    set_pref(output_pref pref)
+    {
+      this->translator::set_pref(pref);
+    }
+
+    using translator::optimization_level;
+
+    void
+    set_level(optimization_level level)
+    {
+      this->translator::set_level(level);
+    }
+
+    /// \brief Clear the LTL simplification caches, and the
+    /// translation cache enabled by the \c fm-cache option.
+    void
+    clear_caches()
+    {
+      this->translator::clear_caches();
+    }
+
+    /// \brief Add \a f to the conjunction.
+    ///
+    /// Return the automaton for the conjunction of all the formulas
+    /// added so far.  Once this conjunction is known to be empty, the
+    /// following conjuncts are not translated anymore.
+    twa_graph_ptr add(formula f);
+
+    /// \brief The automaton for the conjunction of all the formulas
+    /// added so far.
+    ///
+    /// If no formula has been added, this is the automaton for true.
+    twa_graph_ptr automaton();
+
+    /// \brief The conjunction of all the formulas added so far.
+    ///
+    /// The conjuncts that have been translated are given in their
+    /// simplified form.
+    formula conjunction() const;
+
+    /// \brief The automata of all conjuncts, in the order they
+    /// were added.
+    ///
+    /// Conjuncts added after the conjunction became empty have not
+    /// been translated, and are associated to nullptr.
+    const std::vector<twa_graph_ptr>& conjunct_automata() const
+    {
+      return parts_;
+    }
+
+    /// \brief SCC decomposition of automaton().
+    ///
+    /// This is computed once and kept until the next conjunct
+    /// changes the automaton.  Unknown acceptances have been
+    /// determined.
+    const scc_info& get_scc_info();
+
+    /// \brief Whether the conjunction is unsatisfiable.
+    bool is_empty();
+
+    /// \brief Forget all conjuncts.
+    void clear();
+
+  private:
+    std::vector<formula> conjuncts_;
+    std::vector<twa_graph_ptr> parts_;
+    twa_graph_ptr aut_ = nullptr;
+    scc_info* si_ = nullptr;
+  };
   /// @}
 
 }
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2013-2019 Laboratoire de Recherche et Développement
+// Copyright (C) 2013-2020 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -237,6 +237,9 @@ namespace spot
 
   twa_graph_ptr twa_word::as_automaton() const
   {
+    if (SPOT_UNLIKELY(cycle.empty()))
+      throw std::runtime_error("a twa_word may not have an empty cycle");
+
     twa_graph_ptr aut = make_twa_graph(dict_);
 
     aut->prop_weak(true);
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2013, 2014, 2015, 2016, 2018, 2019 Laboratoire de Recherche et
+// Copyright (C) 2013, 2014, 2015, 2016, 2018-2020 Laboratoire de Recherche et
 // Développement de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -81,6 +81,8 @@ namespace spot
     /// \brief Convert the twa_word as an automaton.
     ///
     /// This is useful to evaluate a word on an automaton.
+    ///
+    /// \throw std::runtime_error if the cycle is empty.
     twa_graph_ptr as_automaton() const;
 
     /// \brief Print a twa_word
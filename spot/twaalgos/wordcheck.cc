@@ -0,0 +1,262 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2020 Laboratoire de Recherche et Développement
+// de l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "config.h"
+#include <spot/twaalgos/wordcheck.hh>
+#include <spot/twaalgos/alternation.hh>
+#include <spot/twaalgos/genem.hh>
+#include <spot/misc/bitvect.hh>
+#include <spot/misc/openhash.hh>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace spot
+{
+  word_checker::word_checker(const const_twa_graph_ptr& aut)
+    : aut_(aut->is_existential() ? aut : remove_alternation(aut))
+  {
+  }
+
+  const word_checker::letter_edges&
+  word_checker::edges_of(bdd letter)
+  {
+    auto p = letters_.emplace(letter, letter_edges());
+    letter_edges& res = p.first->second;
+    if (!p.second)
+      return res;
+
+    unsigned ns = aut_->num_states();
+    res.first.reserve(ns + 1);
+    // Many edges share the same label, so compute the conjunction
+    // with LETTER once per label.
+    std::unordered_map<int, bool> compatible;
+    for (unsigned s = 0; s < ns; ++s)
+      {
+        res.first.push_back(res.edges.size());
+        for (auto& e: aut_->out(s))
+          {
+            auto c = compatible.emplace(e.cond.id(), false);
+            if (c.second)
+              c.first->second = (e.cond & letter) != bddfalse;
+            if (c.first->second)
+              res.edges.push_back(aut_->edge_number(e));
+          }
+      }
+    res.first.push_back(res.edges.size());
+    return res;
+  }
+
+  bool
+  word_checker::accepts(const twa_word& word)
+  {
+    // Positions in the cycle are computed modulo its length.
+    if (SPOT_UNLIKELY(word.cycle.empty()))
+      throw std::runtime_error("a twa_word may not have an empty cycle");
+
+    unsigned ns = aut_->num_states();
+
+    // The set of states reached after each letter of the prefix.
+    auto cur = std::unique_ptr<bitvect>(make_bitvect(ns));
+    auto next = std::unique_ptr<bitvect>(make_bitvect(ns));
+    cur->set(aut_->get_init_state_number());
+    for (const bdd& letter: word.prefix)
+      {
+        const letter_edges& le = edges_of(letter);
+        next->clear_all();
+        for (unsigned s = 0; s < ns; ++s)
+          if (cur->get(s))
+            for (unsigned i = le.first[s]; i < le.first[s + 1]; ++i)
+              next->set(aut_->edge_storage(le.edges[i]).dst);
+        if (next->is_fully_clear())
+          return false;
+        std::swap(cur, next);
+      }
+
+    std::vector<const letter_edges*> cycle;
+    for (const bdd& letter: word.cycle)
+      cycle.push_back(&edges_of(letter));
+    if (aut_->acc().uses_fin_acceptance())
+      return has_accepting_cycle_fin_(*cur, cycle);
+    return has_accepting_cycle_(*cur, cycle);
+  }
+
+  // The following functions look for an accepting cycle in the graph
+  // of the pairs (state, position in the cycle) reachable from the
+  // pairs (s, 0) such that s is in INIT.  Pair (s, i) is numbered
+  // s * cycle.size() + i.
+
+  // Without Fin acceptance, an SCC has an accepting cycle iff the
+  // union of the marks of its edges is accepting, so run Couvreur's
+  // SCC-based algorithm on the fly, and stop as soon as an accepting
+  // SCC is found.
+  bool
+  word_checker::has_accepting_cycle_(const bitvect& init,
+                                     const std::vector<const letter_edges*>&
+                                     cycle)
+  {
+    size_t len = cycle.size();
+    // The DFS number of each pair visited, or 0 if its SCC has been
+    // completely explored.
+    open_hash_map<size_t, unsigned> seen;
+    struct root_t
+    {
+      unsigned num;             // DFS number of the root of the SCC
+      acc_cond::mark_t acc;     // marks of the edges of the SCC
+      acc_cond::mark_t in;      // marks of the edge entering the SCC
+    };
+    std::vector<root_t> root;
+    // Pairs whose SCC is being explored, in DFS order.
+    std::vector<size_t> live;
+    struct frame_t
+    {
+      size_t pair;
+      const unsigned* pos;      // next edge to follow
+      const unsigned* end;
+    };
+    std::vector<frame_t> dfs;
+    unsigned num = 0;
+    auto push = [&](size_t pair, acc_cond::mark_t in)
+      {
+        seen.emplace(pair, ++num);
+        root.push_back({num, {}, in});
+        live.push_back(pair);
+        const letter_edges& le = *cycle[pair % len];
+        unsigned s = pair / len;
+        const unsigned* e = le.edges.data();
+        dfs.push_back({pair, e + le.first[s], e + le.first[s + 1]});
+      };
+
+    unsigned ns = aut_->num_states();
+    for (unsigned s = 0; s < ns; ++s)
+      {
+        if (!init.get(s) || seen.count(s * len))
+          continue;
+        push(s * len, {});
+        while (!dfs.empty())
+          {
+            frame_t& f = dfs.back();
+            if (f.pos == f.end)
+              {
+                size_t pair = f.pair;
+                dfs.pop_back();
+                if (root.back().num == seen.find(pair)->second)
+                  {
+                    // PAIR is the root of an SCC without accepting
+                    // cycle.  Forget about this SCC.
+                    root.pop_back();
+                    size_t p;
+                    do
+                      {
+                        p = live.back();
+                        live.pop_back();
+                        seen.find(p)->second = 0;
+                      }
+                    while (p != pair);
+                  }
+                continue;
+              }
+            auto& e = aut_->edge_storage(*f.pos++);
+            size_t i = f.pair % len + 1;
+            size_t dst = e.dst * len + (i == len ? 0 : i);
+            auto it = seen.find(dst);
+            if (it == seen.end())
+              {
+                push(dst, e.acc);
+                continue;
+              }
+            unsigned n = it->second;
+            if (!n)
+              continue;
+            // DST is in the SCC being explored: merge all the SCCs
+            // on the path from DST to the current pair.
+            acc_cond::mark_t acc = e.acc;
+            while (n < root.back().num)
+              {
+                acc |= root.back().acc | root.back().in;
+                root.pop_back();
+              }
+            root.back().acc |= acc;
+            if (aut_->acc().accepting(root.back().acc))
+              return true;
+          }
+      }
+    return false;
+  }
+
+  // With Fin acceptance, an SCC can contain an accepting cycle even
+  // if the union of its marks is not accepting, so build the graph
+  // and use generic_emptiness_check().
+  bool
+  word_checker::has_accepting_cycle_fin_(const bitvect& init,
+                                         const std::vector<const
+                                         letter_edges*>& cycle)
+  {
+    size_t len = cycle.size();
+    // The first state of G is a new initial state.
+    auto g = make_twa_graph(aut_->get_dict());
+    g->set_acceptance(aut_->acc());
+    g->set_init_state(g->new_state());
+    open_hash_map<size_t, unsigned> seen;
+    std::vector<size_t> todo;
+    auto state_of = [&](size_t pair)
+      {
+        auto p = seen.emplace(pair, 0);
+        if (p.second)
+          {
+            unsigned res = g->new_state();
+            p.first->second = res;
+            todo.push_back(pair);
+            return res;
+          }
+        return p.first->second;
+      };
+    unsigned ns = aut_->num_states();
+    for (unsigned s = 0; s < ns; ++s)
+      if (init.get(s))
+        g->new_edge(0, state_of(s * len), bddtrue);
+    while (!todo.empty())
+      {
+        size_t pair = todo.back();
+        todo.pop_back();
+        unsigned src = seen.find(pair)->second;
+        const letter_edges& le = *cycle[pair % len];
+        unsigned s = pair / len;
+        size_t i = pair % len + 1;
+        if (i == len)
+          i = 0;
+        for (unsigned j = le.first[s]; j < le.first[s + 1]; ++j)
+          {
+            auto& e = aut_->edge_storage(le.edges[j]);
+            g->new_edge(src, state_of(e.dst * len + i), bddtrue, e.acc);
+          }
+      }
+    return !generic_emptiness_check(g);
+  }
+
+  std::vector<bool>
+  word_checker::accepts(const std::vector<twa_word_ptr>& words)
+  {
+    std::vector<bool> res;
+    res.reserve(words.size());
+    for (auto& w: words)
+      res.push_back(accepts(*w));
+    return res;
+  }
+}
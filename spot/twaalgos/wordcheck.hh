@@ -0,0 +1,95 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2020 Laboratoire de Recherche et Développement
+// de l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <spot/twa/twagraph.hh>
+#include <spot/twaalgos/word.hh>
+#include <spot/misc/bddlt.hh>
+#include <unordered_map>
+#include <vector>
+
+namespace spot
+{
+  class bitvect;
+
+  /// \ingroup twa_misc
+  /// \brief Check whether lasso-shaped words are accepted by an
+  /// automaton.
+  ///
+  /// Checking a word with <code>product(aut,
+  /// word->as_automaton())</code> and an emptiness check computes the
+  /// conjunction of each letter of the word with each label of the
+  /// automaton, for each word.  This class is meant to check many
+  /// words against the same automaton: it remembers which edges of
+  /// the automaton are compatible with each letter it has seen, and
+  /// then simulates the automaton on each word without any BDD
+  /// operation.  The prefix of a word is read by computing the set
+  /// of states reached after each letter, and the states reachable
+  /// from this set while reading the cycle are explored as pairs
+  /// (state, position in the cycle).  The word is accepted iff the
+  /// graph of these pairs contains an accepting cycle.
+  ///
+  /// Because a twa_word uses Boolean formulas as letters, it actually
+  /// represents a set of words.  A word is said to be accepted if
+  /// one of the words of this set is accepted, as when checking that
+  /// the product of the automaton with the word is not empty.
+  ///
+  /// Alternating automata are first converted with
+  /// remove_alternation(), so they should be weak.
+  class SPOT_API word_checker final
+  {
+  public:
+    /// \brief Prepare to check words against \a aut.
+    ///
+    /// The words should use the same bdd_dict as \a aut.
+    word_checker(const const_twa_graph_ptr& aut);
+
+    /// \brief Whether the automaton accepts \a word.
+    ///
+    /// \throw std::runtime_error if the cycle of \a word is empty.
+    bool accepts(const twa_word& word);
+
+    /// \brief Whether the automaton accepts each of \a words.
+    ///
+    /// Element \c i of the result is the result of
+    /// <code>accepts(*words[i])</code>.  This throws if one of the
+    /// words has an empty cycle.
+    std::vector<bool> accepts(const std::vector<twa_word_ptr>& words);
+
+  private:
+    // The edges of each state that are compatible with a letter,
+    // stored in edges[first[s]] to edges[first[s + 1] - 1].
+    struct letter_edges
+    {
+      std::vector<unsigned> first;
+      std::vector<unsigned> edges;
+    };
+
+    const letter_edges& edges_of(bdd letter);
+    bool has_accepting_cycle_(const bitvect& init,
+                              const std::vector<const letter_edges*>& cycle);
+    bool has_accepting_cycle_fin_(const bitvect& init,
+                                  const std::vector<const letter_edges*>&
+                                  cycle);
+
+    const_twa_graph_ptr aut_;
+    std::unordered_map<bdd, letter_edges, bdd_hash> letters_;
+  };
+}
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-x
-// Copyright (C) 2014, 2015, 2017, 2018, 2019 Laboratoire de Recherche et
+// Copyright (C) 2014, 2015, 2017-2020 Laboratoire de Recherche et
 // Développement de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -25,6 +25,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <spot/twa/acc.hh>
+#include <spot/misc/random.hh>
 
 static void check(spot::acc_cond& ac, spot::acc_cond::mark_t m)
 {
@@ -78,6 +79,10 @@ int main()
   if (!((m4.min_set() == 1) &&
         (m4.max_set() == spot::acc_cond::mark_t::max_accsets() - 1)))
     return 1;
+  if (!((m4.min_set_from(1) == m4.max_set()) &&
+        (m4.min_set_from(m4.max_set()) == 0) &&
+        (m4.lowest() == spot::acc_cond::mark_t({0}))))
+    return 1;
 
   spot::acc_cond::mark_t m0 = {};
   std::cout << m0.max_set() << ' ' << m0.min_set() << '\n';
@@ -237,5 +242,109 @@ int main()
       expect(e, "Too many acceptance sets used.");
     }
 
+  // has() is false for sets that cannot exist.
+  {
+    unsigned max = spot::acc_cond::mark_t::max_accsets();
+    spot::acc_cond::mark_t m = {};
+    m.set(max - 1);
+    if (!m.has(max - 1) || m.has(max) || m.has(-1U))
+      abort();
+  }
+
+  // acc_cond evaluates its condition using a compiled form that
+  // should agree with the interpretation of the acc_code.
+  for (unsigned n = 0; n <= 5; ++n)
+    for (unsigned seed = 0; seed < 100; ++seed)
+      {
+        spot::srand(seed);
+        auto code = spot::acc_cond::acc_code::random(n, (seed % 3) * 0.3);
+        for (auto& c: {code, code.to_dnf(), code.to_cnf()})
+          {
+            spot::acc_cond ac(n, c);
+            for (unsigned i = 0; i < (1U << n); ++i)
+              {
+                spot::acc_cond::mark_t inf = {};
+                for (unsigned s = 0; s < n; ++s)
+                  if (i & (1U << s))
+                    inf.set(s);
+                if (ac.accepting(inf) != c.accepting(inf)
+                    || ac.inf_satisfiable(inf) != c.inf_satisfiable(inf))
+                  {
+                    std::cerr << c << " disagrees on " << inf << '\n';
+                    abort();
+                  }
+                for (auto ap: inf.sets())
+                  {
+                    spot::acc_cond::mark_t m({ap});
+                    if (ac.maybe_accepting(inf, m)
+                        != c.maybe_accepting(inf, m))
+                      {
+                        std::cerr << c << " disagrees on "
+                                  << inf << m << '\n';
+                        abort();
+                      }
+                  }
+              }
+          }
+      }
+
+  // Same check on some common acceptance conditions, mixing Inf and
+  // Fin, and using several sets in each clause.
+  {
+    using acc_code = spot::acc_cond::acc_code;
+    std::vector<unsigned> gr = {1, 0, 2};
+    std::vector<acc_code> codes = {
+      acc_code::fin({0}),
+      acc_code::fin({0, 2}),
+      acc_code::fin({0}) | acc_code::fin({1}),
+      acc_code::inf({0}) & acc_code::fin({1}),
+      acc_code::inf({0, 1}) | acc_code::fin({2, 3}),
+      acc_code::generalized_buchi(4),
+      acc_code::generalized_co_buchi(4),
+      acc_code::rabin(3),
+      acc_code::streett(3),
+      acc_code::parity(true, false, 5),
+      acc_code::parity(false, true, 5),
+      acc_code::generalized_rabin(gr.begin(), gr.end()),
+    };
+    // Later evaluations should see the changes made by
+    // set_acceptance().
+    spot::acc_cond modified(6);
+    for (auto& code: codes)
+      {
+        spot::acc_cond ac(6, code);
+        modified.set_acceptance(code);
+        for (unsigned i = 0; i < 64; ++i)
+          {
+            spot::acc_cond::mark_t inf = {};
+            for (unsigned s = 0; s < 6; ++s)
+              if (i & (1U << s))
+                inf.set(s);
+            bool acc = code.accepting(inf);
+            if (ac.accepting(inf) != acc
+                || modified.accepting(inf) != acc
+                || ac.inf_satisfiable(inf) != code.inf_satisfiable(inf))
+              {
+                std::cerr << code << " disagrees on " << inf << '\n';
+                abort();
+              }
+            for (unsigned j = 0; j < 64; ++j)
+              {
+                spot::acc_cond::mark_t m = {};
+                for (unsigned s = 0; s < 6; ++s)
+                  if (i & j & (1U << s))
+                    m.set(s);
+                if (ac.maybe_accepting(inf, m)
+                    != code.maybe_accepting(inf, m))
+                  {
+                    std::cerr << code << " disagrees on "
+                              << inf << m << '\n';
+                    abort();
+                  }
+              }
+          }
+      }
+  }
+
   return 0;
 }
@@ -18,6 +18,7 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "config.h"
+#include <cassert>
 #include <iostream>
 #include <spot/misc/bitvect.hh>
 
@@ -101,4 +102,15 @@ int main()
             << (a->at(5) > a->at(6)) << std::endl;
 
   delete a;
+
+  // hash() used to ignore the last block of bit vectors whose size
+  // is a multiple of the block size.
+  {
+    spot::bitvect* b1 = spot::make_bitvect(64);
+    spot::bitvect* b2 = spot::make_bitvect(64);
+    b2->set(3);
+    assert(b1->hash() != b2->hash());
+    delete b1;
+    delete b2;
+  }
 }
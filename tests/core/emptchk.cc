@@ -112,9 +112,9 @@ main(int argc, char** argv)
       }
 
       const char* algos[] = {
-        "Cou99", "Cou99(shy)",
+        "Cou99", "Cou99(shy)", "Cou99(packed)",
         "CVWY90", "CVWY90(bsh=10M)", "CVWY90(repeated)",
-        "SE05", "SE05(bsh=10M)", "SE05(repeated)",
+        "SE05", "SE05(bsh=10M)", "SE05(repeated)", "SE05(packed)",
         "Tau03_opt", "GV04",
       };
 
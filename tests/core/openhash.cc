@@ -0,0 +1,108 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2020 Laboratoire de Recherche et Développement
+// de l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#undef NDEBUG
+#include "config.h"
+#include <spot/misc/openhash.hh>
+#include <spot/misc/random.hh>
+#include <cassert>
+#include <map>
+#include <set>
+
+// A poor hash function, to exercise collisions.
+struct bad_hash
+{
+  size_t operator()(unsigned x) const noexcept
+  {
+    return (x % 7) << 20;
+  }
+};
+
+template<class Hash>
+static void check_map(unsigned range)
+{
+  spot::open_hash_map<unsigned, unsigned, Hash> m;
+  std::map<unsigned, unsigned> ref;
+  for (unsigned i = 0; i < 20000; ++i)
+    {
+      unsigned k = spot::mrand(range);
+      switch (spot::mrand(4))
+        {
+        case 0:
+          {
+            auto p = m.emplace(k, i);
+            auto q = ref.emplace(k, i);
+            assert(p.second == q.second);
+            assert(p.first->first == k);
+            assert(p.first->second == q.first->second);
+            break;
+          }
+        case 1:
+          m[k] += i;
+          ref[k] += i;
+          break;
+        case 2:
+          assert(m.erase(k) == ref.erase(k));
+          break;
+        case 3:
+          {
+            auto it = m.find(k);
+            auto rit = ref.find(k);
+            assert((it == m.end()) == (rit == ref.end()));
+            if (it != m.end())
+              assert(it->second == rit->second);
+            break;
+          }
+        }
+      assert(m.size() == ref.size());
+    }
+  std::map<unsigned, unsigned> copy;
+  for (auto& p: m)
+    assert(copy.emplace(p.first, p.second).second);
+  assert(copy == ref);
+  m.clear();
+  assert(m.empty());
+  assert(m.begin() == m.end());
+}
+
+static void check_set()
+{
+  spot::open_hash_set<unsigned, bad_hash> s;
+  s.reserve(100);
+  auto cap = s.capacity();
+  for (unsigned i = 0; i < 100; ++i)
+    assert(s.insert(i * 3).second);
+  assert(s.capacity() == cap);
+  for (unsigned i = 0; i < 300; ++i)
+    assert(s.count(i) == (i % 3 == 0));
+  for (unsigned i = 0; i < 300; i += 2)
+    s.erase(i);
+  std::set<unsigned> res(s.begin(), s.end());
+  assert(res.size() == s.size());
+  for (unsigned i: res)
+    assert(i % 3 == 0 && i % 2 == 1);
+}
+
+int main()
+{
+  check_map<std::hash<unsigned>>(100);
+  check_map<std::hash<unsigned>>(10000);
+  check_map<bad_hash>(100);
+  check_set();
+}
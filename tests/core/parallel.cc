@@ -0,0 +1,135 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2020 Laboratoire de Recherche et Développement de
+// l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "config.h"
+#include <iostream>
+#include <set>
+#include <vector>
+#include <spot/misc/parallel.hh>
+#include <spot/twa/twagraph.hh>
+#include <spot/twaalgos/sccinfo.hh>
+#ifdef ENABLE_PTHREAD
+#  include <chrono>
+#  include <condition_variable>
+#  include <mutex>
+#endif
+
+// Make sure that the parallel code is actually run on several
+// threads when Spot is configured with --enable-pthread, and that it
+// reduces to a sequential loop otherwise.  Each call to the callback
+// waits (for a bounded time) until a second worker shows up, so that
+// a single thread processing all the items is detected.
+static int
+check(const char* what, spot::parallel_policy ppolicy, unsigned n,
+      const std::function<void(const std::function<void(unsigned,
+                                                        unsigned)>&)>& run)
+{
+  std::vector<unsigned> order;
+  std::set<unsigned> workers;
+#ifdef ENABLE_PTHREAD
+  std::mutex m;
+  std::condition_variable cv;
+  bool gave_up = false;
+#endif
+  run([&](unsigned i, unsigned worker)
+      {
+#ifdef ENABLE_PTHREAD
+        std::unique_lock<std::mutex> lock(m);
+        order.push_back(i);
+        workers.insert(worker);
+        cv.notify_all();
+        if (!cv.wait_for(lock, std::chrono::seconds(10),
+                         [&]() { return gave_up || workers.size() > 1; }))
+          gave_up = true;
+#else
+        order.push_back(i);
+        workers.insert(worker);
+#endif
+      });
+
+  int res = 0;
+  if (order.size() != n || std::set<unsigned>(order.begin(),
+                                              order.end()).size() != n)
+    {
+      std::cerr << what << ": some items were not processed once\n";
+      res = 1;
+    }
+  for (unsigned w: workers)
+    if (w >= ppolicy.nthreads())
+      {
+        std::cerr << what << ": unexpected worker " << w << '\n';
+        res = 1;
+      }
+#ifdef ENABLE_PTHREAD
+  if (workers.size() < 2)
+    {
+      std::cerr << what << ": only one thread was used\n";
+      res = 1;
+    }
+#else
+  for (unsigned i = 0; i < order.size(); ++i)
+    if (order[i] != i)
+      {
+        std::cerr << what << ": items processed out of order\n";
+        res = 1;
+        break;
+      }
+#endif
+  return res;
+}
+
+int
+main()
+{
+  spot::parallel_policy ppolicy(4);
+#ifdef ENABLE_PTHREAD
+  unsigned expected = 4;
+#else
+  unsigned expected = 1;
+#endif
+  if (ppolicy.nthreads() != expected)
+    {
+      std::cerr << "nthreads() = " << ppolicy.nthreads()
+                << ", expected " << expected << '\n';
+      return 1;
+    }
+
+  int res = check("parallel_for", ppolicy, 8,
+                  [&](const std::function<void(unsigned, unsigned)>& f)
+                  {
+                    spot::parallel_for(ppolicy, 8, f);
+                  });
+
+  // A chain of 6 SCCs.
+  auto aut = spot::make_twa_graph(spot::make_bdd_dict());
+  aut->new_states(6);
+  for (unsigned s = 0; s < 6; ++s)
+    {
+      aut->new_edge(s, s, bddtrue);
+      if (s < 5)
+        aut->new_edge(s, s + 1, bddtrue);
+    }
+  spot::scc_info si(aut);
+  res |= check("parallel_for_each_scc", ppolicy, si.scc_count(),
+               [&](const std::function<void(unsigned, unsigned)>& f)
+               {
+                 spot::parallel_for_each_scc(si, ppolicy, f);
+               });
+  return res;
+}
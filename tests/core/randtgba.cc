@@ -65,6 +65,7 @@ const char* default_algos[] = {
   "Cou99(poprem)",
   "Cou99(poprem shy !group)",
   "Cou99(poprem shy group)",
+  "Cou99(packed)",
   "Cou99new",
   "Cou99abs",
   "CVWY90",
@@ -72,6 +73,7 @@ const char* default_algos[] = {
   "GV04",
   "SE05",
   "SE05(bsh=4K)",
+  "SE05(packed)",
   "Tau03",
   "Tau03_opt",
   "Tau03_opt(condstack)",
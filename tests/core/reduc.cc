@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*_
-// Copyright (C) 2008-2012, 2014-2016, 2018-2019 Laboratoire
+// Copyright (C) 2008-2012, 2014-2016, 2018-2020 Laboratoire
 // de Recherche et Dveloppement de l'Epita (LRDE).
 // Copyright (C) 2004, 2006, 2007 Laboratoire d'Informatique de Paris
 // 6 (LIP6), dpartement Systmes Rpartis Coopratifs (SRC),
@@ -141,6 +141,16 @@ main(int argc, char** argv)
       o.containment_checks_stronger = true;
       o.favor_event_univ = true;
       break;
+    case 16:
+      // Like 9, but with caches so small that they must evict
+      // entries all the time.
+      o.reduce_basics = true;
+      o.synt_impl = true;
+      o.event_univ = true;
+      o.containment_checks = true;
+      o.containment_checks_stronger = true;
+      o.cache_size_limit = 4096;
+      break;
     default:
       return 2;
   }
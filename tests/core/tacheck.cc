@@ -0,0 +1,180 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2020 Laboratoire de Recherche et Développement
+// de l'Epita (LRDE).
+//
+// This file is part of Spot, a model checking library.
+//
+// Spot is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// Spot is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "config.h"
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <string>
+#include <spot/tl/parse.hh>
+#include <spot/tl/apcollect.hh>
+#include <spot/kripke/kripkegraph.hh>
+#include <spot/ta/tgtaproduct.hh>
+#include <spot/taalgos/emptinessta.hh>
+#include <spot/taalgos/minimize.hh>
+#include <spot/taalgos/tgba2ta.hh>
+#include <spot/twa/twaproduct.hh>
+#include <spot/twaalgos/degen.hh>
+#include <spot/twaalgos/ltl2tgba_fm.hh>
+#include <spot/twaalgos/stutter.hh>
+#include <spot/misc/random.hh>
+
+// For each stutter-invariant formula of the input file, check the
+// products of small random Kripke structures with the testing
+// automata of the formula, built with every combination of the
+// options of tgba_to_ta(), with and without minimization, and with
+// its (minimized or not) TGTA.  The emptiness of each product must
+// agree with the emptiness of the product of the Kripke structure
+// with the TGBA of the formula.  The TA products are checked by
+// ta_check with and without the heuristic that detects
+// livelock-accepting runs during its first pass.
+
+static void
+syntax(char* prog)
+{
+  std::cerr << prog << " file\n";
+  exit(2);
+}
+
+namespace
+{
+  spot::kripke_graph_ptr
+  random_kripke(const spot::bdd_dict_ptr& dict,
+                const spot::atomic_prop_set& aps, unsigned states)
+  {
+    auto k = spot::make_kripke_graph(dict);
+    std::vector<bdd> vars;
+    for (auto ap: aps)
+      vars.push_back(bdd_ithvar(k->register_ap(ap)));
+    for (unsigned s = 0; s < states; ++s)
+      {
+        bdd cond = bddtrue;
+        for (bdd v: vars)
+          cond &= spot::mrand(2) ? v : !v;
+        k->new_state(cond);
+      }
+    for (unsigned s = 0; s < states; ++s)
+      {
+        k->new_edge(s, spot::mrand(states));
+        if (spot::mrand(2))
+          k->new_edge(s, spot::mrand(states));
+      }
+    k->set_init_state(0);
+    return k;
+  }
+
+  struct testing_automaton
+  {
+    spot::const_ta_ptr ta;
+    bool disable_second_pass;
+    const char* name;
+  };
+
+  int
+  check_formula(spot::formula f, const spot::bdd_dict_ptr& dict)
+  {
+    auto tgba = spot::ltl_to_tgba_fm(f, dict);
+    auto sba = spot::degeneralize(tgba);
+    bdd ap_set = spot::atomic_prop_collect_as_bdd(f, tgba);
+    std::vector<testing_automaton> tas;
+    // ta_check requires an artificial initial state.  Only the first
+    // pass is needed on STA, but this does not hold for their
+    // generalized form.
+    for (bool degen: {false, true})
+      for (bool single_pass: {false, true})
+        for (bool livelock: {false, true})
+          {
+            auto ta = spot::tgba_to_ta(degen ? sba : tgba, ap_set, degen,
+                                       true, single_pass, livelock);
+            bool dsp = degen && (single_pass || livelock);
+            tas.push_back({ta, dsp, "TA"});
+            tas.push_back({spot::minimize_ta(ta), dsp, "TA -RT"});
+          }
+    auto tgta = spot::tgba_to_tgta(tgba, ap_set);
+    spot::const_tgta_ptr tgtas[2] = { tgta, spot::minimize_tgta(tgta) };
+
+    spot::atomic_prop_set aps;
+    spot::atomic_prop_collect(f, &aps);
+    int status = 0;
+    for (unsigned n = 1; n <= 20; ++n)
+      {
+        auto k = random_kripke(dict, aps, n);
+        bool expected = !spot::otf_product(k, tgba)->is_empty();
+        auto report = [&](const char* name, unsigned opt, bool r)
+          {
+            std::cerr << "mismatch for " << f << " with " << name
+                      << " #" << opt << " on Kripke structure #" << n
+                      << ": expected " << expected << ", got " << r << '\n';
+            status = 1;
+          };
+        for (unsigned i = 0; i < tas.size(); ++i)
+          {
+            auto prod = spot::product(tas[i].ta, k);
+            for (bool no_heuristic: {false, true})
+              {
+                spot::ta_check tc(prod);
+                bool r = tc.check(tas[i].disable_second_pass, no_heuristic);
+                if (r != expected)
+                  report((std::string(tas[i].name)
+                          + (no_heuristic ? " (no heuristic)" : "")).c_str(),
+                         i / 2, r);
+              }
+          }
+        for (unsigned i = 0; i < 2; ++i)
+          {
+            bool r = !spot::product(k, tgtas[i])->is_empty();
+            if (r != expected)
+              report(i ? "TGTA -RT" : "TGTA", 0, r);
+          }
+      }
+    return status;
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc != 2)
+    syntax(argv[0]);
+  std::ifstream input(argv[1]);
+  if (!input)
+    {
+      std::cerr << "failed to open " << argv[1] << '\n';
+      return 2;
+    }
+
+  spot::srand(0);
+  int status = 0;
+  auto dict = spot::make_bdd_dict();
+  std::string s;
+  while (std::getline(input, s))
+    {
+      if (s.empty() || s[0] == '#') // Skip comments
+        continue;
+      auto pf = spot::parse_infix_psl(s);
+      if (pf.format_errors(std::cerr))
+        return 2;
+      // Testing automata only make sense for stutter-invariant
+      // properties.
+      if (!spot::is_stutter_invariant(pf.f))
+        continue;
+      status |= check_formula(pf.f, dict);
+    }
+  return status;
+}
@@ -1,5 +1,5 @@
 // -*- coding: utf-8 -*-
-// Copyright (C) 2014-2018 Laboratoire de Recherche et Développement
+// Copyright (C) 2014-2018, 2020 Laboratoire de Recherche et Développement
 // de l'Epita (LRDE).
 //
 // This file is part of Spot, a model checking library.
@@ -20,6 +20,7 @@
 #include "config.h"
 #include <iostream>
 #include <spot/twa/twagraph.hh>
+#include <spot/twa/twaproduct.hh>
 #include <spot/twaalgos/dot.hh>
 #include <spot/twaalgos/hoa.hh>
 #include <spot/tl/defaultenv.hh>
@@ -178,6 +179,150 @@ static void f5()
   spot::print_hoa(std::cout, tg) << '\n';
 }
 
+// Test purge_dead_states_and_merge_edges()
+static void f6()
+{
+  auto d = spot::make_bdd_dict();
+  auto tg = make_twa_graph(d);
+  bdd p1 = bdd_ithvar(tg->register_ap("p1"));
+  bdd p2 = bdd_ithvar(tg->register_ap("p2"));
+  tg->set_generalized_buchi(2);
+
+  auto s0 = tg->new_state();      // unreachable
+  auto s1 = tg->new_state();
+  auto s2 = tg->new_state();
+  auto s3 = tg->new_state();
+  auto s4 = tg->new_state();      // dead
+  tg->set_init_state(s1);
+  tg->new_edge(s0, s1, bddtrue);
+  tg->new_edge(s1, s2, p1);
+  tg->new_edge(s1, s4, p1);
+  tg->new_edge(s3, s3, p1, {1});
+  tg->new_edge(s2, s3, p1, {0});
+  tg->new_edge(s1, s2, p2);
+  tg->new_edge(s2, s1, bddtrue);
+  tg->new_edge(s3, s3, !p1, {1});
+  tg->new_edge(s2, s3, p1, {1});
+  tg->new_edge(s3, s2, p2, {0});
+
+  auto tg2 = make_twa_graph(tg, spot::twa::prop_set::all());
+  auto names = [](const spot::twa_graph_ptr& aut)
+    {
+      aut->set_named_prop("state-names",
+                          new std::vector<std::string>({"s0", "s1", "s2",
+                                                        "s3", "s4"}));
+    };
+  names(tg);
+  names(tg2);
+
+  tg->purge_dead_states();
+  tg->merge_edges();
+  tg2->purge_dead_states_and_merge_edges();
+  assert(*tg == *tg2);
+  assert(tg->get_init_state_number() == tg2->get_init_state_number());
+  assert(*tg->get_named_prop<std::vector<std::string>>("state-names")
+         == *tg2->get_named_prop<std::vector<std::string>>("state-names"));
+
+  spot::print_hoa(std::cout, tg2) << '\n';
+}
+
+static void f7()
+{
+  auto d = spot::make_bdd_dict();
+  auto tg = make_twa_graph(d);
+  bdd p1 = bdd_ithvar(tg->register_ap("p1"));
+  tg->set_generalized_buchi(2);
+  unsigned n = 100;
+  tg->new_states(n);
+  // Add edges in an order that is not sorted by source.
+  for (unsigned k = 0; k < 30; ++k)
+    for (unsigned i = 0; i < n; ++i)
+      tg->new_edge((i * 37) % n, (i * k) % n, k % 3 ? p1 : !p1,
+                   {k % 2});
+
+  auto tg2 = make_twa_graph(tg, spot::twa::prop_set::all());
+  tg->get_graph().sort_edges_();
+  tg->get_graph().chain_edges_();
+  tg2->get_graph().sort_edges_srcfirst_();
+  tg2->get_graph().chain_edges_();
+  assert(*tg == *tg2);
+  tg2->get_graph().sort_edges_srcfirst_();
+  tg2->get_graph().chain_edges_();
+  assert(*tg == *tg2);
+}
+
+static void f8()
+{
+  // Large enough to be split between several threads, if Spot was
+  // configured with --enable-pthread.
+  auto d = spot::make_bdd_dict();
+  auto tg = make_twa_graph(d);
+  bdd p1 = bdd_ithvar(tg->register_ap("p1"));
+  tg->set_generalized_buchi(2);
+  unsigned n = 2000;
+  tg->new_states(n + 10);
+  for (unsigned k = 0; k < 70; ++k)
+    for (unsigned i = 0; i < n; ++i)
+      tg->new_edge((i * 37) % n, (i * k) % n, k % 3 ? p1 : !p1,
+                   {k % 2});
+
+  auto tg2 = make_twa_graph(tg, spot::twa::prop_set::all());
+  auto tg3 = make_twa_graph(tg, spot::twa::prop_set::all());
+  auto tg4 = make_twa_graph(tg, spot::twa::prop_set::all());
+  tg->get_graph().sort_edges_();
+  tg->get_graph().chain_edges_();
+  tg2->get_graph().sort_edges_({}, spot::parallel_policy(4));
+  tg2->get_graph().chain_edges_(spot::parallel_policy(4));
+  assert(*tg == *tg2);
+  for (unsigned s = 0; s < n + 10; ++s)
+    assert(tg->get_graph().state_storage(s).succ_tail
+           == tg2->get_graph().state_storage(s).succ_tail);
+  tg3->merge_edges();
+  tg4->merge_edges(spot::parallel_policy(3));
+  assert(*tg3 == *tg4);
+}
+
+static void f9()
+{
+  // Packed states of a product of two automata.
+  auto d = spot::make_bdd_dict();
+  auto tg = make_twa_graph(d);
+  bdd p1 = bdd_ithvar(tg->register_ap("p1"));
+  tg->new_states(5);
+  for (unsigned i = 0; i < 5; ++i)
+    {
+      tg->new_edge(i, (i + 1) % 5, p1);
+      tg->new_edge(i, (i * 3) % 5, !p1);
+    }
+  tg->set_init_state(2);
+  assert(tg->packed_state_words() == 1);
+  auto prod = spot::otf_product(tg, tg);
+  assert(prod->packed_state_words() == 2);
+  std::vector<const spot::state*> todo = { prod->get_init_state() };
+  unsigned seen = 0;
+  while (!todo.empty())
+    {
+      const spot::state* s = todo.back();
+      todo.pop_back();
+      std::uint64_t packed[2];
+      prod->pack_state(s, packed);
+      assert(packed[0] < 5 && packed[1] < 5);
+      const spot::state* u = prod->unpack_state(packed);
+      assert(u->compare(s) == 0);
+      assert(u->hash() == s->hash());
+      u->destroy();
+      unsigned bit = 1U << (packed[0] * 5 + packed[1]);
+      if (!(seen & bit))
+        {
+          seen |= bit;
+          for (auto i: prod->succ(s))
+            todo.push_back(i->dst());
+        }
+      s->destroy();
+    }
+  assert(seen != 0);
+}
+
 int main()
 {
   f1();
@@ -185,4 +330,8 @@ int main()
   f3();
   f4();
   f5();
+  f6();
+  f7();
+  f8();
+  f9();
 }
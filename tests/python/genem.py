@@ -1,5 +1,5 @@
 # -*- mode: python; coding: utf-8 -*-
-# Copyright (C) 2018-2019 Laboratoire de Recherche et Développement de l'Epita
+# Copyright (C) 2018-2020 Laboratoire de Recherche et Développement de l'Epita
 # (LRDE).
 #
 # This file is part of Spot, a model checking library.
@@ -293,6 +293,23 @@ def run_bench(automata):
                + str(res4)[0] + str(res5)[0])
         print(res)
         assert res in ('TTTTT', 'FFFFF')
+        # The result should not depend on the number of threads.
+        # (Several threads are only used with --enable-pthread;
+        # core/parallel.test checks that they really are.)
+        res6 = spot.generic_emptiness_check(aut, spot.parallel_policy(4))
+        assert res6 == res3
+        # Check the parts of the automaton induced by each SCC,
+        # without copying them.
+        si = spot.scc_info(aut)
+        for scc in range(si.scc_count()):
+            keep = spot.vectorbool([si.scc_of(s) == scc
+                                    for s in range(aut.num_states())])
+            filt = spot.scc_and_mark_filter(aut, keep, si.one_state_of(scc))
+            if si.is_accepting_scc(scc):
+                assert not spot.generic_emptiness_check(filt)
+            else:
+                assert (spot.generic_emptiness_check(filt)
+                        == spot.generic_emptiness_check_for_scc(si, scc))
         if res == 'FFFFF':
             run3 = spot.generic_accepting_run(aut)
             assert run3.replay(spot.get_cout()) is True
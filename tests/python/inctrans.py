@@ -0,0 +1,55 @@
+# -*- mode: python; coding: utf-8 -*-
+# Copyright (C) 2020 Laboratoire de Recherche et Développement de
+# l'Epita (LRDE).
+#
+# This file is part of Spot, a model checking library.
+#
+# Spot is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# Spot is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+# License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Check that incremental_translator agrees with the translation of
+# the whole conjunction.
+
+import spot
+
+it = spot.incremental_translator(spot._bdd_dict)
+assert not it.is_empty()
+assert it.automaton().num_states() == 1
+
+conj = []
+for f in ['GFa', 'G(a -> Fb)', 'GF!b', 'G(c -> Xc)', 'FG!b']:
+    f = spot.formula(f)
+    conj.append(f)
+    aut = it.add(f)
+    ref = spot.translate(spot.formula.And(conj))
+    assert spot.are_equivalent(aut, ref)
+    assert it.is_empty() == ref.is_empty()
+assert it.is_empty()
+
+# Conjuncts added to an empty conjunction are not translated.
+it.add(spot.formula('Fc'))
+parts = it.conjunct_automata()
+assert len(parts) == 6
+assert parts[4] is not None
+assert parts[5] is None
+assert it.conjunction().size() == 6
+
+it.clear()
+it.clear_caches()
+it.set_type(spot.postprocessor.BA)
+it.set_pref(spot.postprocessor.Small)
+it.set_level(spot.postprocessor.Medium)
+aut = it.add(spot.formula('GFa'))
+aut = it.add(spot.formula('GFb'))
+assert aut.acc().is_buchi()
+assert spot.are_equivalent(aut, spot.translate('GFa & GFb', 'BA'))
@@ -141,6 +141,17 @@ for (input, output) in [('(a&b)<->b', 'b->(a&b)'),
     assert(f == output)
     assert(spot.are_equivalent(input, output))
 
+# The BDD variables used by as_bdd() for non-Boolean subformulae
+# must not be released when the caches exceed their limit, as the
+# BDDs returned by as_bdd() may still be in use.
+opt = spot.tl_simplifier_options(3)
+opt.cache_size_limit = 64
+simp = spot.tl_simplifier(opt, spot.make_bdd_dict())
+b = simp.as_bdd(spot.formula('a & Gb'))
+simp.simplify('a | b')
+simp.as_bdd(spot.formula('Fc'))
+assert simp.as_bdd(spot.formula('a & Gb')) == b
+
 
 def myparse(input):
     env = spot.default_environment.instance()
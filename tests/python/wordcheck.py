@@ -0,0 +1,38 @@
+# -*- mode: python; coding: utf-8 -*-
+# Copyright (C) 2020 Laboratoire de Recherche et Développement de
+# l'Epita (LRDE).
+#
+# This file is part of Spot, a model checking library.
+#
+# Spot is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# Spot is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+# License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import spot
+
+aut = spot.translate('a U Gb')
+d = aut.get_dict()
+wc = spot.word_checker(aut)
+assert wc.accepts(spot.parse_word('a;a;cycle{b}', d))
+assert not wc.accepts(spot.parse_word('a;cycle{!b}', d))
+assert wc.accepts(spot.parse_word('cycle{b&!a}', d))
+
+# A word with an empty cycle is rejected with the same exception as
+# twa_word::as_automaton().
+w = spot.twa_word(d)
+for f in (w.as_automaton, lambda: wc.accepts(w)):
+    try:
+        f()
+    except RuntimeError as e:
+        assert 'empty cycle' in str(e)
+    else:
+        raise RuntimeError("missing exception")